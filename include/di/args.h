@@ -1,10 +1,12 @@
 #ifndef YAGA_DI_ARGS
 #define YAGA_DI_ARGS
 
-#include <unordered_map>
-#include <typeinfo>
-#include <typeindex>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
 
+#include "di/type_id.h"
 #include "di/type_traits.h"
 
 namespace yaga {
@@ -20,9 +22,11 @@ public:
   inline ArgsIter();
   inline explicit operator bool() const;
 
+  bool movable() const { return movable_; }
+
 private:
-  Args* args_;
-  std::unordered_map<std::type_index, void*>::iterator iter_;
+  void* arg_;
+  bool movable_;
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -30,8 +34,12 @@ class Args
 {
 friend class ArgsIter;
 public:
-  template <typename... Params>
-  Args(Params&&...params);
+  struct Entry
+  {
+    TypeId id;
+    void* arg;
+    bool movable;
+  };
 
   template <typename T>
   ArgsIter find();
@@ -39,27 +47,67 @@ public:
   template <typename T>
   T& get(ArgsIter iter);
 
+  bool empty() const { return count_ == 0; }
+
+protected:
+  Args(const Entry* entries, std::size_t count) : entries_(entries), count_(count) {}
+
 private:
-  std::unordered_map<std::type_index, void*> args_;
+  const Entry* entries_;
+  std::size_t count_;
+};
+
+/*
+ * @brief Entries of an `ArgsArray`, a base class listed first so that they are initialized before `Args` refers to them.
+ */
+template <std::size_t N>
+struct ArgsStorage
+{
+  std::array<Args::Entry, N> storage;
 };
 
+/*
+ * @brief Arguments passed to a factory functor, stored in place.
+ *
+ * The number of arguments is known at compile time, so the entries live in a fixed-size array on the caller's stack
+ * and a lookup is a scan over a handful of type identifiers without any heap allocation. Arguments passed as rvalues
+ * are marked movable, so they are moved into the constructor instead of being copied. The arguments are referenced,
+ * not copied, so they must outlive the array.
+ */
+template <std::size_t N>
+class ArgsArray : private ArgsStorage<N>, public Args
+{
+public:
+  template <typename... Params>
+  explicit ArgsArray(Params&&... params);
+};
+
+template <typename... Params>
+ArgsArray(Params&&... params) -> ArgsArray<sizeof...(Params)>;
+
 // -----------------------------------------------------------------------------------------------------------------------------
 ArgsIter::ArgsIter() :
-  args_(nullptr)
+  arg_(nullptr),
+  movable_(false)
 {
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 ArgsIter::operator bool() const
 {
-  return args_ != nullptr && iter_ != args_->args_.end();
+  return arg_ != nullptr;
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
+template <std::size_t N>
 template <typename... Params>
-Args::Args(Params&&...params)
+ArgsArray<N>::ArgsArray(Params&&... params) :
+  ArgsStorage<N> { { Entry {
+    typeId<Params>(),
+    const_cast<void*>(static_cast<const void*>(std::addressof(params))),
+    !std::is_lvalue_reference_v<Params> && !std::is_const_v<std::remove_reference_t<Params>> }... } },
+  Args(this->storage.data(), N)
 {
-  (..., (args_[typeid(RemoveCVRef<Params>)] = static_cast<void*>(std::addressof(params))));
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -67,8 +115,14 @@ template <typename T>
 ArgsIter Args::find()
 {
   ArgsIter iter;
-  iter.args_ = this;
-  iter.iter_ = args_.find(typeid(RemoveCVRef<T>));
+  auto id = typeId<T>();
+  for (auto i = count_; i > 0; --i) {
+    if (entries_[i - 1].id == id) {
+      iter.arg_ = entries_[i - 1].arg;
+      iter.movable_ = entries_[i - 1].movable;
+      break;
+    }
+  }
   return iter;
 }
 
@@ -76,7 +130,7 @@ ArgsIter Args::find()
 template <typename T>
 T& Args::get(ArgsIter iter)
 {
-  return (T&)(*reinterpret_cast<RemoveCVRef<T>*>(iter.iter_->second));
+  return (T&)(*reinterpret_cast<RemoveCVRef<T>*>(iter.arg_));
 }
 
 } // !namespace di
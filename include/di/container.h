@@ -1,11 +1,24 @@
 #ifndef YAGA_DI_CONTAINER_H
 #define YAGA_DI_CONTAINER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory_resource>
 #include <mutex>
-#include <typeindex>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "di/factory.h"
+#include "di/init_graph.h"
+#include "di/lazy.h"
+#include "di/multi_view.h"
+#include "di/provider.h"
+#include "di/ref.h"
+#include "di/registry.h"
+#include "di/type_id.h"
 #include "di/type_traits.h"
 #include "di/factory_context.h"
 
@@ -18,21 +31,46 @@ constexpr bool IsBaseOf =
   (std::is_same_v<I, T> || std::is_base_of_v<I, T>) &&
   std::is_base_of_v<Scope, S>;
 
+class ResolvedContainer;
+
+/*
+ * @brief Result of `Container::warmup`.
+ *
+ * `instances` counts every shared instance once, even if it is registered under several interfaces. `serialTime` is the
+ * sum of the times spent creating each of them, i.e. roughly how long the warm-up would take on a single thread, and
+ * `wallTime` is how long it actually took.
+ */
+struct WarmupReport
+{
+  std::size_t instances = 0;
+  std::chrono::nanoseconds wallTime {};
+  std::chrono::nanoseconds serialTime {};
+};
+
 // -----------------------------------------------------------------------------------------------------------------------------
 class Container
 {
-template <typename T, int N> friend struct CtorArg;
+template <typename T, int N, typename C> friend struct CtorArg;
 template <int N> friend struct FunctorArg;
 template <typename T> friend struct LambdaHelper;
+template <typename T, typename C> friend class Prefetch;
 
 public:
+  /*
+   * @brief Creates a container.
+   *
+   * @param resource The memory resource shared objects and `std::pmr::vector` results are allocated from.
+   *                 By default the global `new` is used.
+   */
+  explicit Container(std::pmr::memory_resource* resource = nullptr) : resource_(resource) {}
+
   /*
    * @brief Registers the class `T` in the container, associating it with the interface `I` and using the scope `S`.
    *
    * @tparam I The interface type under which the class `T` is registered.
    * @tparam T The class type being registered, which must be derived from `I`.
    * @tparam S The scope type for object registration, defaulting to `UniqueScope`.
-   *           Possible values: UniqueScope, SharedScope, SharedImlpScope.
+   *           Possible values: UniqueScope, SharedScope, SharedImlpScope, ThreadScope, PoolScope.
    * @tparam CallInit A boolean flag indicating whether to call the `init` method of `T` during instantiation, defaulting to false.
    * @return Container& A reference to the container for method chaining.
    */
@@ -44,7 +82,7 @@ public:
    *
    * @tparam T The class type being registered.
    * @tparam S The scope type for object registration, defaulting to `UniqueScope`.
-   *           Possible values: UniqueScope, SharedScope, SharedImlpScope.
+   *           Possible values: UniqueScope, SharedScope, SharedImlpScope, ThreadScope, PoolScope.
    * @tparam CallInit A boolean flag indicating whether to call the `init` method of `T` during instantiation, defaulting to false.
    * @return Container& A reference to the container for method chaining.
    */
@@ -79,7 +117,7 @@ public:
    * 
    * @tparam I The interface type under which the factory function is registered.
    * @tparam S The scope type for object registration, defaulting to `UniqueScope`.
-   *           Possible values: UniqueScope, SharedScope, SharedImlpScope.
+   *           Possible values: UniqueScope, SharedScope, SharedImlpScope, ThreadScope.
    * @tparam F The factory function type, which must return a pointer or a smart pointer to a type derived from `I`.
    * @param functor The factory function that will create instances of `I`. The return type of `functor` should be a pointer 
    *                or smart pointer to a type derived from `I`.
@@ -98,7 +136,7 @@ public:
    * The container will use the factory function to create instances of the type when requested.
    * 
    * @tparam S The scope type for object registration, defaulting to `UniqueScope`.
-   *           Possible values: UniqueScope, SharedScope, SharedImlpScope.
+   *           Possible values: UniqueScope, SharedScope, SharedImlpScope, ThreadScope.
    * @tparam F The factory function type, which must return a pointer or a smart pointer.
    * @param functor The factory function that will create instances of `I`.
    *                The return type of `functor` should be a pointer or a smart pointer.
@@ -116,7 +154,7 @@ public:
    * @tparam I The interface type under which the class `T` is registered.
    * @tparam T The class type being registered, which must be derived from `I`.
    * @tparam S The scope type for object registration, defaulting to `UniqueScope`.
-   *           Possible values: UniqueScope, SharedScope, SharedImlpScope.
+   *           Possible values: UniqueScope, SharedScope, SharedImlpScope, ThreadScope, PoolScope.
    * @tparam CallInit A boolean flag indicating whether to call the `init` method of `T` during instantiation, defaulting to false.
    * @return Container& A reference to the container for method chaining.
    */
@@ -131,23 +169,43 @@ public:
    *
    * @tparam T The class type being registered.
    * @tparam S The scope type for object registration, defaulting to `UniqueScope`.
-   *           Possible values: UniqueScope, SharedScope, SharedImlpScope.
+   *           Possible values: UniqueScope, SharedScope, SharedImlpScope, ThreadScope, PoolScope.
    * @tparam CallInit A boolean flag indicating whether to call the `init` method of `T` during instantiation, defaulting to false.
    * @return Container& A reference to the container for method chaining.
    */
   template <typename T, typename S = UniqueScope, bool CallInit = false>
   EnableIf<IsBaseOf<T, T, S>, Container&> addMulti();
 
+  /*
+   * @brief Allocates the shared objects of the registration for the interface `I` from the memory resource `resource`.
+   *
+   * Raw and unique pointers are released with `delete` by their owners, so they are always allocated with `new`.
+   *
+   * @tparam I The interface type the registration is looked up by.
+   * @param resource The memory resource, or nullptr to fall back to the resource of the container.
+   * @return Container& A reference to the container for method chaining.
+   */
+  template <typename I>
+  Container& setResource(std::pmr::memory_resource* resource);
+
+  /*
+   * @brief Returns the memory resource of the container, or nullptr if the global `new` is used.
+   */
+  std::pmr::memory_resource* resource() const { return resource_; }
+
   /*
    * @brief Creates an instance of the class `T` from the container, resolving dependencies.
    *
    * All constructor arguments required by `T` will also be created from the container recursively.
+   * The arguments `params` override the container for the parameters of their types, as if `T` was created through
+   * a `std::function<T(Params...)>`, but no function object is created.
    *
    * @tparam T The class type to be created.
+   * @param params The runtime arguments passed to the constructors.
    * @return T An instance of the class `T`.
    */
-  template <typename T>
-  T create();
+  template <typename T, typename... Params>
+  T create(Params&&... params);
 
   /*
    * @brief Creates a pointer to and instance of the class `T` from the container, resolving dependencies.
@@ -157,8 +215,8 @@ public:
    * @tparam T The class type for which a pointer will be created.
    * @return T* A pointer to an instance of the class `T`.
    */
-  template <typename T>
-  T* createPtr() { return create<T*>(); }
+  template <typename T, typename... Params>
+  T* createPtr(Params&&... params) { return create<T*>(std::forward<Params>(params)...); }
 
   /*
    * @brief Creates a shared pointer to and instance of the class `T` from the container, resolving dependencies.
@@ -168,8 +226,8 @@ public:
    * @tparam T The class type for which a shared pointer will be created.
    * @return std::shared_ptr<T> A shared pointer to an instance of the class `T`.
    */
-  template <typename T>
-  std::shared_ptr<T> createShared() { return create<std::shared_ptr<T>>(); }
+  template <typename T, typename... Params>
+  std::shared_ptr<T> createShared(Params&&... params) { return create<std::shared_ptr<T>>(std::forward<Params>(params)...); }
 
   /*
    * @brief Creates a unique pointer to and instance of the class `T` from the container, resolving dependencies.
@@ -179,40 +237,195 @@ public:
    * @tparam T The class type for which a unique pointer will be created.
    * @return std::unique_ptr<T> A unique pointer to an instance of the class `T`.
    */
+  template <typename T, typename... Params>
+  std::unique_ptr<T> createUnique(Params&&... params) { return create<std::unique_ptr<T>>(std::forward<Params>(params)...); }
+
+  /*
+   * @brief Creates an instance of the class `T` on the executor `executor`, resolving dependencies.
+   *
+   * Classes registered with `CallInit` may provide `std::future<void> initAsync()` instead of `init`. The asynchronous
+   * initializations started while resolving `T` run concurrently and the future becomes ready once all of them finish.
+   * Note that the objects are passed to their dependants before their `initAsync` completes.
+   *
+   * @tparam T The class type to be created.
+   * @tparam E The executor type, a callable that accepts a `std::function<void()>` and runs it.
+   * @param executor The executor the creation is submitted to.
+   * @return std::future<T> A future of an instance of the class `T`.
+   */
+  template <typename T, typename E>
+  std::future<T> createAsync(E executor);
+
+  /*
+   * @brief Creates an instance of the class `T` on a new thread, resolving dependencies.
+   *
+   * @see createAsync
+   */
   template <typename T>
-  std::unique_ptr<T> createUnique() { return create<std::unique_ptr<T>>(); }
+  std::future<T> createAsync();
+
+  /*
+   * @brief Creates an instance of the class `T`, resolving independent dependencies concurrently on the executor `executor`.
+   *
+   * The constructor arguments of every class created during the call are created concurrently before its constructor
+   * runs, provided all its parameters are pointers, vectors, `Container*` or injectable handles such as `Provider`,
+   * otherwise they are resolved one after another as usual. The elements of every vector of classes registered with
+   * `addMulti` are created concurrently as well.
+   *
+   * @tparam T The class type to be created.
+   * @tparam E The executor type, a callable that accepts a `std::function<void()>` and runs it.
+   * @param executor The executor the independent dependencies are submitted to.
+   * @return T An instance of the class `T`.
+   */
+  template <typename T, typename E>
+  T createParallel(E executor);
+
+  /*
+   * @brief Creates an instance of the class `T`, resolving independent dependencies concurrently on new threads.
+   *
+   * @see createParallel
+   */
+  template <typename T>
+  T createParallel();
+
+  /*
+   * @brief Creates an instance of the class `T`, deferring the `init` methods until the whole object graph is built.
+   *
+   * The `init` and `initAsync` methods of the objects created during the call, see `CallInit`, are collected together
+   * with the objects each of them was constructed from. Once the graph is built they are run on the executor `executor`,
+   * every object after the objects it depends on and independent objects concurrently. Objects created by value are
+   * initialized during the build, after the initializations they depend on. Shared instances are published once their
+   * initialization succeeded and reset if it failed. Note that the objects must not be destroyed before the call returns.
+   *
+   * @tparam T The class type to be created.
+   * @tparam E The executor type, a callable that accepts a `std::function<void()>` and runs it.
+   * @param executor The executor the initializations are submitted to.
+   * @param report If not nullptr, receives the time taken by each initialization.
+   * @return T An instance of the class `T`.
+   */
+  template <typename T, typename E>
+  T createDeferred(E executor, InitReport* report = nullptr);
+
+  /*
+   * @brief Creates an instance of the class `T`, deferring the `init` methods and running them on new threads.
+   *
+   * @see createDeferred
+   */
+  template <typename T>
+  T createDeferred(InitReport* report = nullptr);
+
+  /*
+   * @brief Finishes the registration and returns an immutable view of the container.
+   *
+   * Any further registration throws, so the registrations seen through the view can no longer change.
+   *
+   * @return ResolvedContainer A view of the container that only allows object creation.
+   */
+  inline ResolvedContainer freeze();
+
+  /*
+   * @brief Eagerly creates all SharedScope and SharedImlpScope instances on `threads` concurrent workers.
+   *
+   * Instances are picked up in registration order, a dependency that is already being created by another worker is
+   * waited for, and one that is not is created by the worker that needs it. The `init` methods are called as usual.
+   * The first exception thrown by a constructor is rethrown once all workers finish.
+   *
+   * @tparam E The executor type, a callable that accepts a `std::function<void()>` and runs it, e.g. on a thread pool.
+   * @param executor The executor the workers are submitted to, it must be able to run `threads` tasks concurrently.
+   * @param threads The number of workers.
+   * @return WarmupReport The number of instances created together with the wall and the serial time.
+   */
+  template <typename E>
+  WarmupReport warmup(E executor, std::size_t threads);
+
+  /*
+   * @brief Eagerly creates all SharedScope and SharedImlpScope instances on `threads` new threads.
+   *
+   * @see warmup
+   */
+  inline WarmupReport warmup(std::size_t threads);
+
+  /*
+   * @brief Checks whether the container was frozen with `freeze`.
+   *
+   * @return bool True if no more registrations are allowed.
+   */
+  bool frozen() const { return frozen_.load(std::memory_order_acquire); }
 
 private:
   template <typename T>
-  T createImpl(Args* args);
+  T createImpl(Args* args, PlanStep* step = nullptr);
+
+  template <typename T>
+  T createAndWaitInits();
+
+  template <typename T>
+  EnableIf<IsPointer<T>, T> createSpecial(Args* args, PlanStep* step);
+
+  template <typename T>
+  EnableIf<IsFunction<T>, T> createSpecial(Args* args, PlanStep* step);
+
+  template <typename T>
+  EnableIf<IsVector<T>, T> createSpecial(Args* args, PlanStep* step);
 
   template <typename T>
-  EnableIf<IsPointer<T>, T> createSpecial(Args* args);
+  EnableIf<IsProvider<T>, T> createSpecial(Args* args, PlanStep* step);
 
   template <typename T>
-  EnableIf<IsFunction<T>, T> createSpecial(Args* args);
+  EnableIf<IsLazy<T>, T> createSpecial(Args* args, PlanStep* step);
 
   template <typename T>
-  EnableIf<IsVector<T>, T> createSpecial(Args* args);
+  EnableIf<IsRef<T>, T> createSpecial(Args* args, PlanStep* step);
+
+  template <typename T>
+  EnableIf<IsMultiView<T>, T> createSpecial(Args* args, PlanStep* step);
 
   template <typename T>
   EnableIf<
     !IsVector<T>     &&
     !IsFunction<T> &&
+    !IsProvider<T> &&
+    !IsLazy<T> &&
+    !IsRef<T> &&
+    !IsMultiView<T> &&
     !IsPointer<T>,
-  T> createSpecial(Args* args);
+  T> createSpecial(Args* args, PlanStep* step);
 
   template <typename T>
   void throwIfExists();
 
+  inline void throwIfFrozen();
+
+  inline void registered();
+
   template <typename T>
   Factory* findFactory(bool throwEx = true);
 
+  template <typename T>
+  const std::vector<Factory*>* findMultiFactories();
+
+  template <typename T>
+  const T* findCachedVector(Args* args);
+
+  template <typename E, typename V>
+  void createElements(V& result, const std::vector<Factory*>& factories, Args* args);
+
+  template <typename I>
+  void setFactory(FactorySPtr factory);
+
+  inline void addMultiFactory(TypeId id, FactorySPtr factory);
+
 private:
+  std::pmr::memory_resource* resource_;
   std::mutex factoryMutex_;
+  std::atomic<bool> frozen_ { false };
+  std::atomic<std::size_t> generation_ { 0 };
+  std::atomic<bool> specialKeys_ { false };
   FactoryContext factoryContext_;
-  std::unordered_map<std::type_index, FactorySPtr> factories_;
-  std::unordered_multimap<std::type_index, FactorySPtr> multiFactories_;
+  Registry<Factory> factories_;
+  Registry<const std::vector<Factory*>> multiFactories_;
+  Registry<const void> cachedVectors_;
+  std::vector<FactorySPtr> registered_;
+  std::vector<std::shared_ptr<const void>> retained_;
 };
 
 } // !namespace di
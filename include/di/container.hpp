@@ -1,13 +1,20 @@
 #ifndef YAGA_DI_CONTAINER_HPP
 #define YAGA_DI_CONTAINER_HPP
 
+#include <condition_variable>
+#include <exception>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <unordered_set>
 
 #include "di/container.h"
 #include "di/factory.hpp"
+#include "di/parallel_tasks.h"
+#include "di/resolution_context.h"
+#include "di/resolved_container.h"
 
-#define THROW_NOT_REGISTERED throw std::runtime_error(std::string("Class ") + typeid(T).name() + " not registered");
+#define THROW_NOT_REGISTERED throw std::runtime_error(std::string("Class ") + typeName<T>() + " not registered");
 
 namespace yaga {
 namespace di {
@@ -23,8 +30,7 @@ struct LambdaHelper<std::function<Ret(Params...)>>
   static std::function<Ret(Params...)> createLambda(Container* container)
   {
     return [container](Params&&... params) {
-      Args args(std::forward<Params>(params)...);
-      std::lock_guard<std::mutex> lock(container->factoryMutex_);
+      ArgsArray args(std::forward<Params>(params)...);
       return container->template createImpl<Ret>(&args);
     };
   }
@@ -36,8 +42,10 @@ EnableIf<IsBaseOf<I, T, S>, Container&> Container::add()
 {
   using Interface = RemoveCVRef<I>;
   std::lock_guard<std::mutex> lock(factoryMutex_);
+  throwIfFrozen();
   throwIfExists<Interface>();
-  factories_[typeid(Interface)] = createFactory<S, I, T>(CallInit, &factoryContext_);
+  setFactory<Interface>(createFactory<S, I, T>(CallInit, &factoryContext_));
+  registered();
   return *this;
 }
 
@@ -54,8 +62,10 @@ EnableIf<IsBaseOf<I, T, S>, Container&> Container::add(std::shared_ptr<T> instan
 {
   using Interface = RemoveCVRef<I>;
   std::lock_guard<std::mutex> lock(factoryMutex_);
+  throwIfFrozen();
   throwIfExists<Interface>();
-  factories_[typeid(Interface)] = createFactory<S, I, T>(instance, &factoryContext_);
+  setFactory<Interface>(createFactory<S, I, T>(instance, &factoryContext_));
+  registered();
   return *this;
 }
 
@@ -76,8 +86,11 @@ Container&> Container::addFactory(F functor)
 {
   using ReturnType = typename FunctionTraits<F>::ReturnType;
   using T = typename PointerTraits<ReturnType>::ElementType;
+  std::lock_guard<std::mutex> lock(factoryMutex_);
+  throwIfFrozen();
   throwIfExists<I>();
-  factories_[typeid(I)] = createFunctorFactory<S, I, T, F>(functor, &factoryContext_);
+  setFactory<I>(createFunctorFactory<S, I, T, F>(functor, &factoryContext_));
+  registered();
   return *this;
 }
 
@@ -96,7 +109,9 @@ EnableIf<IsBaseOf<I, T, S>, Container&> Container::addMulti()
 {
   using Interface = RemoveCVRef<I>;
   std::lock_guard<std::mutex> lock(factoryMutex_);
-  multiFactories_.emplace(typeid(Interface), createFactory<S, I, T>(CallInit, &factoryContext_));
+  throwIfFrozen();
+  addMultiFactory(typeId<Interface>(), createFactory<S, I, T>(CallInit, &factoryContext_));
+  registered();
   return *this;
 }
 
@@ -107,74 +122,355 @@ EnableIf<IsBaseOf<T, T, S>, Container&> Container::addMulti()
   return addMulti<T, T, S, CallInit>();
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I>
+Container& Container::setResource(std::pmr::memory_resource* resource)
+{
+  using T = RemoveCVRef<I>;
+  std::lock_guard<std::mutex> lock(factoryMutex_);
+  throwIfFrozen();
+  auto factory = findFactory<T>();
+  factory->setResource(resource);
+  return *this;
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 void Container::throwIfExists()
 {
-  auto it = factories_.find(typeid(T));
-  if (it != factories_.end()) throw std::runtime_error(std::string("Class ") + typeid(T).name() + " already registered");
+  if (findFactory<T>(false)) throw std::runtime_error(std::string("Class ") + typeName<T>() + " already registered");
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
-template <typename T>
-T Container::create()
+void Container::throwIfFrozen()
+{
+  if (frozen_.load(std::memory_order_relaxed)) throw std::runtime_error("Container is frozen, registration is not allowed");
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void Container::registered()
+{
+  generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+ResolvedContainer Container::freeze()
 {
   std::lock_guard<std::mutex> lock(factoryMutex_);
+  frozen_.store(true, std::memory_order_release);
+  return ResolvedContainer(this);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename E>
+WarmupReport Container::warmup(E executor, std::size_t threads)
+{
+  std::vector<Factory*> factories;
+  {
+    // an instance registered under several interfaces is created, counted and timed once
+    std::unordered_set<const void*> keys;
+    std::lock_guard<std::mutex> lock(factoryMutex_);
+    factories.reserve(registered_.size());
+    for (auto& factory : registered_) {
+      auto key = factory->instanceKey();
+      if (key && keys.insert(key).second) factories.push_back(factory.get());
+    }
+  }
+  struct State
+  {
+    std::atomic<std::size_t> next { 0 };
+    std::atomic<std::size_t> instances { 0 };
+    std::atomic<std::chrono::nanoseconds::rep> serialTime { 0 };
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t running = 0;
+    std::exception_ptr error;
+  } state;
+
+  auto start = std::chrono::steady_clock::now();
+  state.running = threads ? threads : 1;
+  for (std::size_t i = state.running; i > 0; --i) {
+    executor(std::function<void()>([this, &state, &factories]() {
+      for (auto n = state.next++; n < factories.size(); n = state.next++) {
+        try {
+          auto begin = std::chrono::steady_clock::now();
+          if (!factories[n]->warmup(this)) continue;
+          auto time = std::chrono::steady_clock::now() - begin;
+          state.serialTime += std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+          ++state.instances;
+        }
+        catch (...) {
+          std::lock_guard<std::mutex> lock(state.mutex);
+          if (!state.error) state.error = std::current_exception();
+        }
+      }
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (--state.running == 0) state.done.notify_all();
+    }));
+  }
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.done.wait(lock, [&state]() { return state.running == 0; });
+  if (state.error) std::rethrow_exception(state.error);
+
+  WarmupReport report;
+  report.instances = state.instances;
+  report.wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  report.serialTime = std::chrono::nanoseconds(state.serialTime.load());
+  return report;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+WarmupReport Container::warmup(std::size_t threads)
+{
+  std::vector<std::thread> workers;
+  auto join = [&workers]() {
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  };
+  try {
+    auto report = warmup([&workers](std::function<void()> task) { workers.emplace_back(std::move(task)); }, threads);
+    join();
+    return report;
+  }
+  catch (...) {
+    join();
+    throw;
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename... Params>
+T Container::create(Params&&... params)
+{
+  if constexpr (sizeof...(Params) == 0) {
+    return createImpl<T>(nullptr);
+  }
+  else {
+    ArgsArray args(std::forward<Params>(params)...);
+    return createImpl<T>(&args);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename E>
+std::future<T> Container::createAsync(E executor)
+{
+  auto promise = std::make_shared<std::promise<T>>();
+  auto future = promise->get_future();
+  executor(std::function<void()>([this, promise]() {
+    try {
+      promise->set_value(createAndWaitInits<T>());
+    }
+    catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  }));
+  return future;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+std::future<T> Container::createAsync()
+{
+  return std::async(std::launch::async, [this]() { return createAndWaitInits<T>(); });
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename E>
+T Container::createParallel(E executor)
+{
+  ResolutionContext::Executor parallelExecutor(std::move(executor));
+  ResolutionContext::Parallel parallel(&parallelExecutor, {});
   return createImpl<T>(nullptr);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
-T Container::createImpl(Args* args)
+T Container::createParallel()
+{
+  std::mutex mutex;
+  std::vector<std::thread> workers;
+  auto join = [&workers]() {
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  };
+  try {
+    T result = createParallel<T>([&mutex, &workers](std::function<void()> task) {
+      std::lock_guard<std::mutex> lock(mutex);
+      workers.emplace_back(std::move(task));
+    });
+    join();
+    return result;
+  }
+  catch (...) {
+    join();
+    throw;
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename E>
+T Container::createDeferred(E executor, InitReport* report)
+{
+  ResolutionContext::Executor initExecutor(std::move(executor));
+  InitGraph graph;
+  T result = createImpl<T>(nullptr);
+  auto initReport = graph.run(initExecutor);
+  if (report) *report = std::move(initReport);
+  return result;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+T Container::createDeferred(InitReport* report)
+{
+  std::vector<std::thread> workers;
+  auto join = [&workers]() {
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  };
+  try {
+    T result = createDeferred<T>([&workers](std::function<void()> task) { workers.emplace_back(std::move(task)); }, report);
+    join();
+    return result;
+  }
+  catch (...) {
+    join();
+    throw;
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+T Container::createAndWaitInits()
+{
+  ResolutionContext::PendingInits inits;
+  T result = createImpl<T>(nullptr);
+  inits.wait();
+  return result;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+T Container::createImpl(Args* args, PlanStep* step)
 {
   if (auto it = args ? args->find<T>() : ArgsIter()) {
-    return std::forward<T>(args->get<T>(it));
+    if constexpr (IsReference<T>) return args->get<T>(it);
+    else if constexpr (IsCopyable<T>) {
+      if (it.movable()) return std::move(args->get<T>(it));
+      return args->get<T>(it);
+    }
+    else return std::move(args->get<T>(it));
+  }
+  auto generation = generation_.load(std::memory_order_relaxed);
+  if (auto factory = step ? step->get(generation) : nullptr) {
+    return factory->template createObject<RemoveCV<T>>(this, args);
+  }
+  // Unless such a type was registered itself, a pointer, vector or handle is always resolved by its element type.
+  if constexpr (IsSpecial<T>) {
+    if (!specialKeys_.load(std::memory_order_relaxed)) return createSpecial<T>(args, step);
   }
   if (auto factory = findFactory<T>(false)) {
+    if (step) step->set(factory, generation);
     return factory->template createObject<RemoveCV<T>>(this, args);
   }
-  return createSpecial<T>(args);
+  return createSpecial<T>(args, step);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
-EnableIf<IsPointer<T>, T> Container::createSpecial(Args* args)
+EnableIf<IsPointer<T>, T> Container::createSpecial(Args* args, PlanStep* step)
 {
   using E = typename PointerTraits<T>::ElementType;
   auto factory = findFactory<E>();
+  if (step) step->set(factory, generation_.load(std::memory_order_relaxed));
   return factory->template createObject<RemoveCV<T>>(this, args);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
-EnableIf<IsFunction<T>, T> Container::createSpecial(Args*)
+EnableIf<IsFunction<T>, T> Container::createSpecial(Args*, PlanStep*)
 {
   return LambdaHelper<RemoveCVRef<T>>::createLambda(this);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
-EnableIf<IsVector<T>, T> Container::createSpecial(Args* args)
+EnableIf<IsVector<T>, T> Container::createSpecial(Args* args, PlanStep*)
 {
   using Vector = RemoveCV<T>;
   using VectorElement = typename VectorTraits<Vector>::ElementType;
   using Element = typename PointerTraits<VectorElement>::ElementType;
-  Vector result {};
-  auto range = multiFactories_.equal_range(typeid(Element));
-  for (decltype(range.first) it = range.first; it != range.second; ++it) {
-    result.push_back(it->second->template createObject<VectorElement>(this, args));
+  if constexpr (std::is_same_v<Vector, std::vector<Element*>>) {
+    if (auto cached = findCachedVector<Vector>(args)) return *cached;
   }
-  if (result.empty()) THROW_NOT_REGISTERED;
+  auto factories = findMultiFactories<Element>();
+  if (!factories) THROW_NOT_REGISTERED;
+  auto result = [this]() {
+    using Allocator = typename Vector::allocator_type;
+    if constexpr (std::is_constructible_v<Allocator, std::pmr::memory_resource*>) {
+      return Vector(Allocator(resource_ ? resource_ : std::pmr::get_default_resource()));
+    }
+    else {
+      return Vector();
+    }
+  }();
+  createElements<VectorElement>(result, *factories, args);
   return result;
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+EnableIf<IsProvider<T>, T> Container::createSpecial(Args*, PlanStep*)
+{
+  using Element = typename ProviderTraits<RemoveCV<T>>::ElementType;
+  return T(this, findFactory<Element>());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+EnableIf<IsLazy<T>, T> Container::createSpecial(Args* args, PlanStep* step)
+{
+  using Result = typename LazyTraits<RemoveCV<T>>::ResultType;
+  return T(createSpecial<Provider<Result>>(args, step));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+EnableIf<IsRef<T>, T> Container::createSpecial(Args* args, PlanStep*)
+{
+  using Element = typename RefTraits<RemoveCV<T>>::ElementType;
+  auto factory = findFactory<Element>();
+  if (!factory->holdsInstance()) {
+    throw std::runtime_error(std::string("Class ") + typeName<Element>() + " is not a shared instance, it cannot be referenced");
+  }
+  return T(factory->template createObject<Element*>(this, args));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+EnableIf<IsMultiView<T>, T> Container::createSpecial(Args*, PlanStep*)
+{
+  using Element = typename PointerTraits<typename MultiViewTraits<RemoveCV<T>>::ElementType>::ElementType;
+  auto factories = findMultiFactories<Element>();
+  if (!factories) THROW_NOT_REGISTERED;
+  return T(this, factories);
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 EnableIf<
   !IsVector<T> &&
   !IsFunction<T> &&
+  !IsProvider<T> &&
+  !IsLazy<T> &&
+  !IsRef<T> &&
+  !IsMultiView<T> &&
   !IsPointer<T>
-, T> Container::createSpecial(Args*)
+, T> Container::createSpecial(Args*, PlanStep*)
 {
   THROW_NOT_REGISTERED;
 }
@@ -183,12 +479,97 @@ EnableIf<
 template <typename T>
 Factory* Container::findFactory(bool throwEx)
 {
-  auto it = factories_.find(typeid(RemoveCVRef<T>));
-  if (it == factories_.end()) {
-    if (throwEx) THROW_NOT_REGISTERED;
+  auto factory = factories_.find(typeId<T>());
+  if (!factory && throwEx) THROW_NOT_REGISTERED;
+  return factory;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+const std::vector<Factory*>* Container::findMultiFactories()
+{
+  return multiFactories_.find(typeId<T>());
+}
+
+/*
+ * @brief Returns the vector of all the instances registered under the element type of `T`.
+ *
+ * If all of them are shared instances, the vector cannot change until the next `addMulti`, so it is created once and
+ * kept by the container. Returns nullptr if any of them is not a shared instance.
+ */
+template <typename T>
+const T* Container::findCachedVector(Args* args)
+{
+  if constexpr (!IsVector<T>) {
     return nullptr;
   }
-  return it->second.get();
+  else {
+    using Element = typename PointerTraits<typename VectorTraits<T>::ElementType>::ElementType;
+    if constexpr (!std::is_same_v<T, std::vector<Element*>>) {
+      return nullptr;
+    }
+    else {
+      auto id = typeId<Element>();
+      if (auto cached = cachedVectors_.find(id)) return static_cast<const T*>(cached);
+      // The instances created by a resolution whose initializations are in progress may still be reset.
+      if (ResolutionContext::current()) return nullptr;
+      auto factories = findMultiFactories<Element>();
+      if (!factories) return nullptr;
+      for (auto& factory : *factories) {
+        if (!factory->holdsInstance()) return nullptr;
+      }
+      auto result = std::make_shared<T>();
+      createElements<Element*>(*result, *factories, args);
+      std::lock_guard<std::mutex> lock(factoryMutex_);
+      if (auto cached = cachedVectors_.find(id)) return static_cast<const T*>(cached);
+      if (findMultiFactories<Element>() == factories) cachedVectors_.set(id, result.get());
+      retained_.push_back(result);
+      return result.get();
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename E, typename V>
+void Container::createElements(V& result, const std::vector<Factory*>& factories, Args* args)
+{
+  auto executor = ResolutionContext::executor();
+  if (!executor || factories.size() < 2) {
+    result.reserve(factories.size());
+    for (auto factory : factories) {
+      result.push_back(factory->template createObject<E>(this, args));
+    }
+    return;
+  }
+  result.resize(factories.size());
+  ParallelTasks tasks(executor);
+  for (std::size_t i = 0; i < factories.size(); ++i) {
+    tasks.add([this, &result, &factories, args, i]() { result[i] = factories[i]->template createObject<E>(this, args); });
+  }
+  tasks.run();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I>
+void Container::setFactory(FactorySPtr factory)
+{
+  if constexpr (IsSpecial<RemoveCVRef<I>>) specialKeys_.store(true, std::memory_order_relaxed);
+  factories_.set(typeId<I>(), factory.get());
+  registered_.push_back(std::move(factory));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void Container::addMultiFactory(TypeId id, FactorySPtr factory)
+{
+  auto previous = multiFactories_.find(id);
+  auto factories = previous
+    ? std::make_shared<std::vector<Factory*>>(*previous)
+    : std::make_shared<std::vector<Factory*>>();
+  factories->push_back(factory.get());
+  multiFactories_.set(id, factories.get());
+  cachedVectors_.set(id, nullptr);
+  registered_.push_back(std::move(factory));
+  retained_.push_back(std::move(factories));
 }
 
 } // !namespace di
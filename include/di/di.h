@@ -3,5 +3,8 @@
 
 #include "di/container.h"
 #include "di/container.hpp"
+#include "di/request_scope.h"
+#include "di/resolved_container.h"
+#include "di/static_container.h"
 
 #endif // !YAGA_DI
@@ -1,11 +1,15 @@
 #ifndef YAGA_DI_FACTORY_H
 #define YAGA_DI_FACTORY_H
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <type_traits>
 
 #include "di/args.h"
 #include "di/scope.h"
+#include "di/type_id.h"
 #include "di/type_traits.h"
 
 namespace yaga {
@@ -48,12 +52,76 @@ public:
 
   virtual bool allowInstanceCreation() = 0;
 
+  /*
+   * @brief Checks whether the factory holds its instance for the lifetime of the container.
+   */
+  virtual bool holdsInstance() { return false; }
+
+  /*
+   * @brief Creates the shared instance of the factory ahead of the first request.
+   *
+   * @return bool False if the factory does not hold a shared instance.
+   */
+  virtual bool warmup(Container*) { return false; }
+
+  /*
+   * @brief Identifies the shared instance the factory holds, factories sharing an instance return the same key.
+   *
+   * @return const void* The key, or nullptr if the factory does not hold a shared instance.
+   */
+  virtual const void* instanceKey() const { return nullptr; }
+
+  /*
+   * @brief Sets the memory resource the shared objects of this registration are allocated from.
+   *
+   * @param resource The memory resource, or nullptr to use the resource of the container.
+   */
+  void setResource(std::pmr::memory_resource* resource) { resource_.store(resource, std::memory_order_release); }
+
+protected:
+  inline std::pmr::memory_resource* resource(Container* container) const;
+
 protected:
   bool callInit_;
+  std::atomic<std::pmr::memory_resource*> resource_ { nullptr };
 };
 
 using FactorySPtr = std::shared_ptr<Factory>;
 
+/*
+ * @brief A recorded resolution of a single constructor argument.
+ *
+ * Stores the factory the argument was resolved with, together with the container generation it is valid for.
+ * Any registration increments the generation, so a step recorded earlier is resolved again.
+ */
+class PlanStep
+{
+public:
+  PlanStep() : factory_(nullptr), generation_(0) {}
+
+  inline Factory* get(std::size_t generation) const;
+
+  inline void set(Factory* factory, std::size_t generation);
+
+private:
+  std::atomic<Factory*> factory_;
+  std::atomic<std::size_t> generation_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+Factory* PlanStep::get(std::size_t generation) const
+{
+  if (generation_.load(std::memory_order_acquire) != generation) return nullptr;
+  return factory_.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void PlanStep::set(Factory* factory, std::size_t generation)
+{
+  factory_.store(factory, std::memory_order_relaxed);
+  generation_.store(generation, std::memory_order_release);
+}
+
 } // !namespace di
 } // !namespace yaga
 
@@ -7,10 +7,14 @@
 #include "di/factory.h"
 #include "di/factory_context.h"
 #include "di/object_factory.h"
+#include "di/pool_factory.h"
+#include "di/request_arena.h"
 #include "di/shared_factory.h"
 #include "di/shared_functor_factory.h"
 #include "di/shared_impl_factory.h"
 #include "di/shared_impl_functor_factory.h"
+#include "di/thread_factory.h"
+#include "di/thread_functor_factory.h"
 #include "di/unique_factory.h"
 #include "di/unique_functor_factory.h"
 
@@ -38,6 +42,20 @@ EnableIf<IsSame<S, SharedImlpScope>, FactorySPtr> createFactory(bool callInit, F
   return std::make_shared<SharedImlpFactory<I, T>>(context, callInit);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename S, typename I, typename T>
+EnableIf<IsSame<S, ThreadScope>, FactorySPtr> createFactory(bool callInit, FactoryContext*)
+{
+  return std::make_shared<ThreadFactory<I, T>>(callInit);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename S, typename I, typename T>
+EnableIf<PoolScopeTraits<S>::value, FactorySPtr> createFactory(bool callInit, FactoryContext*)
+{
+  return std::make_shared<PoolFactory<I, T>>(PoolScopeTraits<S>::capacity, callInit);
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename S, typename I, typename T>
 EnableIf<IsSame<S, SharedScope>, FactorySPtr> createFactory(std::shared_ptr<T> instance, FactoryContext*)
@@ -75,6 +93,20 @@ EnableIf<IsSame<S, SharedImlpScope>, FactorySPtr> createFunctorFactory(F functor
   return std::make_shared<SharedImlpFunctorFactory<I, T, F>>(context, functor);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename S, typename I, typename T, typename F>
+EnableIf<IsSame<S, ThreadScope>, FactorySPtr> createFunctorFactory(F functor, FactoryContext*)
+{
+  return std::make_shared<ThreadFunctorFactory<I, T, F>>(functor);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+std::pmr::memory_resource* Factory::resource(Container* container) const
+{
+  auto resource = resource_.load(std::memory_order_acquire);
+  return resource ? resource : container->resource();
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 EnableIf<IsPurePtr<T>, T> Factory::createObject(Container* container, Args* args)
@@ -87,6 +119,7 @@ template <typename T>
 EnableIf<IsSharedPtr<T>, T> Factory::createObject(Container* container, Args* args)
 {
   using E = typename std::pointer_traits<T>::element_type;
+  RequestArena::Suspension suspension;
   return std::static_pointer_cast<E>(createShared(container, args));
 }
 
@@ -95,6 +128,7 @@ template <typename T>
 EnableIf<IsIniquePtr<T>, T> Factory::createObject(Container* container, Args* args)
 {
   using E = typename std::pointer_traits<T>::element_type;
+  RequestArena::Suspension suspension;
   return std::unique_ptr<E>(static_cast<E*>(createUnique(container, args)));
 }
 
@@ -114,9 +148,10 @@ EnableIf<
 , T> Factory::createObject(Container* container, Args* args)
 {
   if (allowInstanceCreation()) {
+    RequestArena::Suspension suspension;
     return ObjectFactory::create<T>(container, args, callInit_);
   }
-  throw std::runtime_error(std::string("Class ") + typeid(T).name() + " instantiation is not allowed by scope");
+  throw std::runtime_error(std::string("Class ") + typeName<T>() + " instantiation is not allowed by scope");
 }
 
 } // !namespace di
@@ -2,8 +2,9 @@
 #define YAGA_DI_FACTORY_CONTEXT
 
 #include <memory>
-#include <typeindex>
-#include <unordered_map>
+#include <vector>
+
+#include "di/type_id.h"
 
 namespace yaga {
 namespace di {
@@ -15,17 +16,18 @@ public:
   T* get();
 
 private:
-  std::unordered_map<std::type_index, std::shared_ptr<void>> storage_;
+  std::vector<std::shared_ptr<void>> storage_;
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 T* FactoryContext::get()
 {
-  auto it = storage_.find(typeid(T));
-  if (it != storage_.end()) return std::static_pointer_cast<T>(it->second).get();
+  auto id = typeId<T>();
+  if (id < storage_.size() && storage_[id]) return std::static_pointer_cast<T>(storage_[id]).get();
+  if (id >= storage_.size()) storage_.resize(id + 1);
   auto ptr = std::make_shared<T>();
-  storage_[typeid(T)] = ptr;
+  storage_[id] = ptr;
   return ptr.get();
 }
 
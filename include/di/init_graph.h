@@ -0,0 +1,291 @@
+#ifndef YAGA_DI_INIT_GRAPH
+#define YAGA_DI_INIT_GRAPH
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "di/resolution_context.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Result of `Container::createDeferred`.
+ *
+ * `inits` lists the initializations in the order they finished with the time each of them took, `serialTime` is their
+ * sum and `wallTime` is how long the initialization phase actually took.
+ */
+struct InitReport
+{
+  struct Entry
+  {
+    std::string type;
+    std::chrono::nanoseconds time {};
+  };
+
+  std::vector<Entry> inits;
+  std::chrono::nanoseconds wallTime {};
+  std::chrono::nanoseconds serialTime {};
+};
+
+/*
+ * @brief The `init` methods deferred by `createDeferred` together with their dependency edges.
+ *
+ * While the graph is being built, every object created on this thread opens a frame which collects the objects created
+ * or reused for its constructor, they become the dependencies of its node. The nodes are run once the whole object
+ * graph is built, each one after all its dependencies and independent ones concurrently. The graph is the settlement
+ * of the resolution, so the shared instances created for it are only published once their nodes have run.
+ */
+class InitGraph : public ResolutionContext::Settlement
+{
+public:
+  struct Node
+  {
+    std::function<void()> init;
+    std::string type;
+    std::vector<Node*> dependencies;
+    std::vector<Node*> dependants;
+    std::size_t waiting = 0;
+    bool done = false;
+    std::promise<void> finished;
+  };
+
+  /*
+   * @brief Collects the dependencies of a single object while it is being created.
+   */
+  class Frame
+  {
+  public:
+    Frame() : graph_(current()) { if (graph_) graph_->frames_.emplace_back(); }
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+    ~Frame() { if (graph_) graph_->frames_.pop_back(); }
+
+    bool active() const { return graph_ != nullptr; }
+
+    /*
+     * @brief Closes the frame, adding a node with the initialization `init` to the enclosing frame.
+     *
+     * A node without an initialization only passes on its dependencies, it is not added if there are none.
+     *
+     * @return Node* The node, or nullptr if none was added.
+     */
+    inline Node* finish(std::function<void()> init = nullptr, std::string type = std::string());
+
+    /*
+     * @brief Runs the initializations the frame depends on right away, in dependency order.
+     *
+     * Used for an object whose initialization cannot be deferred, e.g. one created by value.
+     */
+    void flush() { if (graph_) graph_->flush(graph_->frames_.back()); }
+
+  private:
+    InitGraph* graph_;
+  };
+
+  InitGraph() : previous_(current()) { current() = this; }
+  InitGraph(const InitGraph&) = delete;
+  InitGraph& operator=(const InitGraph&) = delete;
+  ~InitGraph() { current() = previous_; }
+
+  /*
+   * @brief Returns the graph being built on this thread, or nullptr if there is none.
+   */
+  static InitGraph*& current()
+  {
+    thread_local InitGraph* graph = nullptr;
+    return graph;
+  }
+
+  /*
+   * @brief Associates the instance identified by `key` with the node `node` of the object created for it.
+   */
+  void bind(const void* key, Node* node) { if (node) instances_[key] = node; }
+
+  /*
+   * @brief Records that the instance identified by `key` was reused by the object being created.
+   */
+  inline void reuse(const void* key);
+
+  /*
+   * @brief Stops collecting and runs all the initializations on the executor `executor`.
+   *
+   * The calling thread runs the initializations no worker has picked up. The first exception is rethrown once all the
+   * started initializations finish, the initializations that did not start yet are skipped and the shared instances
+   * created for the graph are reset.
+   */
+  inline InitReport run(const ResolutionContext::Executor& executor);
+
+private:
+  struct State
+  {
+    std::deque<Node> nodes;
+    std::deque<Node*> ready;
+    std::size_t remaining = 0;
+    std::size_t queued = 0;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::exception_ptr error;
+    InitReport report;
+
+    inline bool runOne(std::unique_lock<std::mutex>& lock);
+  };
+
+  inline void depend(Node* node);
+
+  inline void flush(const std::vector<Node*>& nodes);
+
+private:
+  InitGraph* previous_;
+  std::shared_ptr<State> state_ = std::make_shared<State>();
+  std::vector<std::vector<Node*>> frames_ { 1 };
+  std::unordered_map<const void*, Node*> instances_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+InitGraph::Node* InitGraph::Frame::finish(std::function<void()> init, std::string type)
+{
+  if (!graph_) return nullptr;
+  auto dependencies = std::move(graph_->frames_.back());
+  graph_->frames_.pop_back();
+  auto graph = graph_;
+  graph_ = nullptr;
+  if (!init && dependencies.empty()) return nullptr;
+  auto& node = graph->state_->nodes.emplace_back();
+  node.init = std::move(init);
+  node.type = std::move(type);
+  node.dependencies = std::move(dependencies);
+  graph->add(node.finished.get_future().share());
+  graph->depend(&node);
+  return &node;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void InitGraph::reuse(const void* key)
+{
+  auto it = instances_.find(key);
+  if (it != instances_.end()) depend(it->second);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void InitGraph::depend(Node* node)
+{
+  auto& dependencies = frames_.back();
+  if (std::find(dependencies.begin(), dependencies.end(), node) == dependencies.end()) dependencies.push_back(node);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void InitGraph::flush(const std::vector<Node*>& nodes)
+{
+  for (auto node : nodes) {
+    if (node->done) continue;
+    flush(node->dependencies);
+    if (node->init) {
+      auto begin = std::chrono::steady_clock::now();
+      {
+        // still building, the graph keeps owning the instances it created
+        ResolutionContext::PendingInits inits;
+        inits.leave();
+        node->init();
+        inits.wait();
+      }
+      auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+      state_->report.inits.push_back({ node->type, time });
+      state_->report.serialTime += time;
+    }
+    node->done = true;
+    node->finished.set_value();
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+bool InitGraph::State::runOne(std::unique_lock<std::mutex>& lock)
+{
+  if (ready.empty()) return false;
+  auto node = ready.front();
+  ready.pop_front();
+  if (node->init && !error) {
+    lock.unlock();
+    std::exception_ptr failure;
+    auto begin = std::chrono::steady_clock::now();
+    try {
+      ResolutionContext::PendingInits inits;
+      node->init();
+      inits.wait();
+    }
+    catch (...) {
+      failure = std::current_exception();
+    }
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+    lock.lock();
+    if (failure && !error) error = failure;
+    report.inits.push_back({ node->type, time });
+    report.serialTime += time;
+  }
+  if (error) node->finished.set_exception(error);
+  else node->finished.set_value();
+  for (auto dependant : node->dependants) {
+    if (--dependant->waiting == 0) ready.push_back(dependant);
+  }
+  --remaining;
+  changed.notify_all();
+  return true;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+InitReport InitGraph::run(const ResolutionContext::Executor& executor)
+{
+  current() = previous_;
+  leave();
+  auto state = state_;
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(state->mutex);
+  for (auto& node : state->nodes) {
+    if (node.done) continue;
+    ++state->remaining;
+    for (auto dependency : node.dependencies) {
+      if (dependency->done) continue;
+      ++node.waiting;
+      dependency->dependants.push_back(&node);
+    }
+  }
+  for (auto& node : state->nodes) {
+    if (!node.done && node.waiting == 0) state->ready.push_back(&node);
+  }
+  while (state->remaining > 0) {
+    while (state->queued + 1 < state->ready.size()) {
+      ++state->queued;
+      lock.unlock();
+      executor([state]() {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        --state->queued;
+        while (state->runOne(lock)) {
+        }
+      });
+      lock.lock();
+    }
+    if (!state->runOne(lock)) state->changed.wait(lock);
+  }
+  lock.unlock();
+  settle(!state->error);
+  if (state->error) std::rethrow_exception(state->error);
+  state->report.wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  return state->report;
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_INIT_GRAPH
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef YAGA_DI_LAZY_H
+#define YAGA_DI_LAZY_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "di/provider.h"
+#include "di/type_traits.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Injectable handle deferring the creation of an object of the type `T` until its first use.
+ *
+ * Only the factory of `T` is looked up when the handle is injected. The object, together with its own dependencies, is
+ * created on the first dereference, which is thread-safe, later dereferences only check a flag. The handle can be moved
+ * before its first use, and the container must outlive it.
+ *
+ * @tparam T The type of the created object, e.g. `Service*`, `std::shared_ptr<Service>` or `std::unique_ptr<Service>`.
+ */
+template <typename T>
+class Lazy
+{
+public:
+  using ResultType = T;
+
+  Lazy() = default;
+
+  explicit Lazy(Provider<T> provider) : provider_(provider) {}
+
+  Lazy(Lazy&& other);
+
+  Lazy& operator=(Lazy&&) = delete;
+
+  /*
+   * @brief Returns the object, creating it on the first call.
+   */
+  T& get();
+
+  T& operator*() { return get(); }
+
+  auto operator->()
+  {
+    if constexpr (IsPointer<T>) return &*get();
+    else return &get();
+  }
+
+  /*
+   * @brief Checks whether the object has already been created.
+   */
+  bool created() const { return created_.load(std::memory_order_acquire); }
+
+private:
+  Provider<T> provider_;
+  std::optional<T> value_;
+  std::atomic<bool> created_ { false };
+  std::mutex mutex_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+Lazy<T>::Lazy(Lazy&& other) :
+  provider_(other.provider_)
+{
+  if (other.created()) {
+    value_.emplace(std::move(*other.value_));
+    created_.store(true, std::memory_order_relaxed);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+T& Lazy<T>::get()
+{
+  if (!created_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!created_.load(std::memory_order_relaxed)) {
+      value_.emplace(provider_());
+      created_.store(true, std::memory_order_release);
+    }
+  }
+  return *value_;
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_LAZY_H
\ No newline at end of file
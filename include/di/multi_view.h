@@ -0,0 +1,106 @@
+#ifndef YAGA_DI_MULTI_VIEW_H
+#define YAGA_DI_MULTI_VIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "di/args.h"
+#include "di/factory.h"
+
+namespace yaga {
+namespace di {
+
+class Container;
+
+/*
+ * @brief Injectable view of the classes registered with `addMulti`, creating each element on demand.
+ *
+ * Unlike `std::vector<T>`, injecting the view creates none of the elements, an element is created only when it is
+ * accessed, every time it is accessed. The view sees the registrations made before it was injected, in registration
+ * order. The container must outlive the view. The elements may be created after the `create` call the view was injected
+ * by has returned, so they do not see its runtime arguments, those are passed to `create` of the view instead.
+ *
+ * @tparam T The type of the elements, e.g. `IPlugin*`, `std::shared_ptr<IPlugin>` or `std::unique_ptr<IPlugin>`.
+ */
+template <typename T>
+class MultiView
+{
+public:
+  class Iterator
+  {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = T;
+    using pointer = void;
+
+    Iterator() : view_(nullptr), index_(0) {}
+
+    Iterator(const MultiView* view, std::size_t index) : view_(view), index_(index) {}
+
+    T operator*() const { return (*view_)[index_]; }
+
+    Iterator& operator++() { ++index_; return *this; }
+
+    Iterator operator++(int) { auto result = *this; ++index_; return result; }
+
+    bool operator==(const Iterator& other) const { return view_ == other.view_ && index_ == other.index_; }
+
+  private:
+    const MultiView* view_;
+    std::size_t index_;
+  };
+
+  using ElementType = T;
+
+  MultiView() : container_(nullptr), factories_(nullptr) {}
+
+  MultiView(Container* container, const std::vector<Factory*>* factories) : container_(container), factories_(factories) {}
+
+  std::size_t size() const { return factories_ ? factories_->size() : 0; }
+
+  bool empty() const { return size() == 0; }
+
+  /*
+   * @brief Creates the element registered at the position `index`, resolving dependencies.
+   */
+  T operator[](std::size_t index) const { return create(index); }
+
+  /*
+   * @brief Creates the element registered at the position `index`, resolving dependencies.
+   *
+   * @param params The runtime arguments passed to the constructors, see `Container::create`.
+   */
+  template <typename... Params>
+  T create(std::size_t index, Params&&... params) const;
+
+  Iterator begin() const { return Iterator(this, 0); }
+
+  Iterator end() const { return Iterator(this, size()); }
+
+private:
+  Container* container_;
+  const std::vector<Factory*>* factories_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+template <typename... Params>
+T MultiView<T>::create(std::size_t index, Params&&... params) const
+{
+  if constexpr (sizeof...(Params) == 0) {
+    return (*factories_)[index]->template createObject<T>(container_, nullptr);
+  }
+  else {
+    ArgsArray args(std::forward<Params>(params)...);
+    return (*factories_)[index]->template createObject<T>(container_, &args);
+  }
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_MULTI_VIEW_H
\ No newline at end of file
@@ -1,24 +1,45 @@
 #ifndef YAGA_DI_OBJECT_FACTORY
 #define YAGA_DI_OBJECT_FACTORY
 
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <utility>
 
 #include "di/container.h"
+#include "di/init_graph.h"
+#include "di/parallel_tasks.h"
+#include "di/resolution_context.h"
 #include "di/type_traits.h"
 
 namespace yaga {
 namespace di {
 
+template <typename T>
+class Plan;
+
 // -----------------------------------------------------------------------------------------------------------------------------
 class ObjectFactory
 {
 public:
-  template <typename T>
-  static T create(Container* container, Args* args, bool callInit);
-
-  template <typename T>
-  static T* createPtr(Container* container, Args* args, bool callInit);
+  template <typename T, typename C>
+  static T create(C* container, Args* args, bool callInit);
+
+  template <typename T, typename C>
+  static T* createPtr(C* container, Args* args, bool callInit, Plan<T>* plan = nullptr);
+
+  template <typename T, typename C>
+  static std::shared_ptr<T> createShared(
+    C* container,
+    Args* args,
+    bool callInit,
+    Plan<T>* plan = nullptr,
+    std::pmr::memory_resource* resource = nullptr);
+
+  template <typename T, typename C>
+  static T* createAt(void* place, C* container, Args* args, bool callInit, Plan<T>* plan = nullptr);
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -33,23 +54,138 @@ constexpr auto IsCreatable(...) -> bool {
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
-template <typename T, int N>
+template <typename T, typename C>
+class Prefetch;
+
+/*
+ * @brief Temporaries bound to the `const U&` constructor parameters of a single construction.
+ *
+ * Small temporaries are placed into an inline buffer, larger ones are allocated with `new`. They are destroyed in
+ * reverse creation order once the construction is over. Constructions that cannot bind any, see `BindsTemporaries`,
+ * do without.
+ */
+class Temporaries
+{
+public:
+  Temporaries() = default;
+  Temporaries(const Temporaries&) = delete;
+  Temporaries& operator=(const Temporaries&) = delete;
+  inline ~Temporaries();
+
+  /*
+   * @brief Stores the object returned by `create`.
+   */
+  template <typename U, typename F>
+  const U& emplace(F create);
+
+private:
+  struct Node
+  {
+    void (*destroy)(Node*);
+    Node* next;
+  };
+
+  template <typename U>
+  struct Holder : Node
+  {
+    template <typename F>
+    explicit Holder(F& create) : Node { nullptr, nullptr }, value(create()) {}
+    U value;
+  };
+
+private:
+  alignas(std::max_align_t) std::byte buffer_[64];
+  std::size_t used_ = 0;
+  Node* head_ = nullptr;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, int N, typename C = Container>
 struct CtorArg
 {
   template <typename U, typename = EnableIf<!IsSame<T, U> && IsCreatable<U>(0)>>
-  operator U() { return container_->createImpl<U>(args_); }
+  operator U()
+  {
+    if (auto value = prefetch_ ? prefetch_->template take<U>(N) : nullptr) return std::move(*value);
+    return container_->template createImpl<U>(args_, step());
+  }
 
-  operator Container*() { return container_; }
+  operator C*() { return container_; }
 
-  template <typename U, typename = EnableIf<!IsSame<T, U> && !IsCreatable<U>(0)>>
-  operator U&() { return container_->createImpl<U&>(args_); }
+  template <typename U, typename = EnableIf<!IsSame<T, U> && (!IsCreatable<U>(0) || std::is_const_v<U>)>>
+  operator U&()
+  {
+    if constexpr (std::is_const_v<U> && IsCreatable<U>(0)) return constRef<RemoveCV<U>>();
+    else return container_->template createImpl<U&>(args_, step());
+  }
 
-  operator Container&() { return *container_; }
+  operator C&() { return *container_; }
 
-  Container* container_;
+  PlanStep* step() { return plan_ ? plan_->step(N) : nullptr; }
+
+  template <typename U>
+  const U& constRef();
+
+  C* container_;
   Args* args_;
+  Plan<T>* plan_;
+  Prefetch<T, C>* prefetch_ = nullptr;
+  Temporaries* temporaries_ = nullptr;
 };
 
+// -----------------------------------------------------------------------------------------------------------------------------
+Temporaries::~Temporaries()
+{
+  while (auto node = head_) {
+    head_ = node->next;
+    node->destroy(node);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename U, typename F>
+const U& Temporaries::emplace(F create)
+{
+  using H = Holder<U>;
+  constexpr auto size = (sizeof(H) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+  H* holder = nullptr;
+  if constexpr (size <= sizeof(buffer_) && alignof(H) <= alignof(std::max_align_t)) {
+    if (used_ + size <= sizeof(buffer_)) {
+      holder = new (buffer_ + used_) H(create);
+      holder->destroy = [](Node* node) { static_cast<H*>(node)->~H(); };
+      used_ += size;
+    }
+  }
+  if (!holder) {
+    holder = new H(create);
+    holder->destroy = [](Node* node) { delete static_cast<H*>(node); };
+  }
+  holder->next = head_;
+  head_ = holder;
+  return holder->value;
+}
+
+/*
+ * @brief Binds a `const U&` constructor parameter.
+ *
+ * An argument created ahead by `Prefetch`, a matching runtime argument or a vector of shared instances cached by the
+ * container is bound directly, otherwise the object is created from the container into a temporary of the
+ * construction, which lives until the constructor returns.
+ */
+template <typename T, int N, typename C>
+template <typename U>
+const U& CtorArg<T, N, C>::constRef()
+{
+  if (auto value = prefetch_ ? prefetch_->template take<U>(N) : nullptr) return *value;
+  if (auto it = args_ ? args_->find<U>() : ArgsIter()) {
+    return args_->get<const U&>(it);
+  }
+  if constexpr (IsVector<U> && requires { container_->template findCachedVector<U>(args_); }) {
+    if (auto cached = container_->template findCachedVector<U>(args_)) return *cached;
+  }
+  return temporaries_->template emplace<U>([this]() { return container_->template createImpl<U>(args_, step()); });
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T, int... N>
 constexpr decltype(T(CtorArg<T, N>{}...), 0) countCtorArgs(int)
@@ -64,9 +200,234 @@ constexpr int countCtorArgs(...)
   return countCtorArgs<T, N..., sizeof...(N)>(0);
 }
 
+/*
+ * @brief Resolution plan of the constructor arguments of the class `T`.
+ *
+ * Each factory owns a plan for the class it creates. The first creation records the factory every argument was resolved
+ * with, later creations replay it without looking the arguments up in the container.
+ */
+template <typename T>
+class Plan
+{
+public:
+  PlanStep* step(int n) { return &steps_[n]; }
+
+private:
+  std::array<PlanStep, countCtorArgs<T>(0)> steps_;
+};
+
+/*
+ * @brief Constructor arguments of the class `T` created concurrently ahead of the construction.
+ *
+ * Used while `createParallel` is in progress. The argument types are discovered by a construction with placeholder
+ * arguments which throws once all of them are converted, before the constructor runs. It is only possible when all
+ * the parameters are pointers, vectors or the other types with a cheap empty value, and each of them can only be
+ * initialized through a conversion of its placeholder, which is checked at compile time, so the constructor body is
+ * never entered. The pointers and vectors are then created on the executor and handed over to the real construction,
+ * by value or bound to a `const&` parameter, the remaining parameters are resolved as usual.
+ */
+template <typename T, typename C>
+class Prefetch
+{
+public:
+  Prefetch(C* container, Args* args, Plan<T>* plan) : container_(container), args_(args), plan_(plan) {}
+  Prefetch(const Prefetch&) = delete;
+  Prefetch& operator=(const Prefetch&) = delete;
+  inline ~Prefetch();
+
+  /*
+   * @brief Discovers and creates the arguments if a parallel resolution is in progress on this thread.
+   *
+   * @return Prefetch* This object, or nullptr if the arguments will be resolved during the construction.
+   */
+  template <int... N>
+  Prefetch* start(std::integer_sequence<int, N...>);
+
+  /*
+   * @brief Returns the created argument `n` if it has the type `U`.
+   */
+  template <typename U>
+  U* take(int n);
+
+  template <typename U>
+  void discover(int n);
+
+private:
+  struct Discovered {};
+
+  struct Slot
+  {
+    void (*create)(Prefetch*, int) = nullptr;
+    void (*destroy)(void*) = nullptr;
+    void* value = nullptr;
+    TypeId id = 0;
+  };
+
+  static constexpr int count = countCtorArgs<T>(0);
+
+private:
+  C* container_;
+  Args* args_;
+  Plan<T>* plan_;
+  std::unique_ptr<Slot[]> slots_;
+  int discovered_ = 0;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, int N, typename C>
+struct PrefetchArg
+{
+  template <typename U, typename = EnableIf<!IsSame<T, U> && IsSpecial<U>>>
+  operator U()
+  {
+    prefetch_->template discover<U>(N);
+    return U();
+  }
+
+  operator C*()
+  {
+    prefetch_->template discover<C*>(N);
+    return nullptr;
+  }
+
+  Prefetch<T, C>* prefetch_;
+};
+
+/*
+ * @brief Argument without any conversion, standing in for one a constructor template takes as it is.
+ */
+struct OpaqueArg {};
+
+/*
+ * @brief Checks whether the class `T` can be constructed with an argument without any conversion at the position `K`,
+ * e.g. by a constructor template, in which case the conversions of that argument cannot be observed. The other
+ * arguments are the placeholders `A`.
+ */
+template <typename T, typename C, template <typename, int, typename> class A, int K, typename S>
+struct AcceptsOpaqueAt;
+
+template <typename T, typename C, template <typename, int, typename> class A, int K, int... N>
+struct AcceptsOpaqueAt<T, C, A, K, std::integer_sequence<int, N...>> :
+  std::bool_constant<std::is_constructible_v<T, std::conditional_t<N == K, OpaqueArg, A<T, N, C>>...>>
+{
+};
+
+/*
+ * @brief Placeholder argument with the conversions of `CtorArg`, except that binding a `const&` parameter to an object
+ * created for it is deleted.
+ */
+template <typename T, int N, typename C>
+struct ConstRefProbe
+{
+  template <typename U, typename = EnableIf<!IsSame<T, U> && IsCreatable<U>(0)>>
+  operator U();
+
+  operator C*();
+
+  template <typename U, typename = EnableIf<!IsSame<T, U> && !IsCreatable<U>(0)>>
+  operator U&();
+
+  template <typename U, typename = EnableIf<!IsSame<T, U> && std::is_const_v<U> && IsCreatable<U>(0)>, typename = void>
+  operator U&() = delete;
+
+  operator C&();
+};
+
+/*
+ * @brief Checks whether constructing the class `T` may bind a `const&` parameter to a temporary, in which case the
+ * construction needs `Temporaries`. A constructor that accepts opaque arguments is assumed to do so.
+ */
+template <typename T, typename C, int... N>
+constexpr bool BindsTemporaries =
+  !std::is_constructible_v<T, ConstRefProbe<T, N, C>...> ||
+  (AcceptsOpaqueAt<T, C, ConstRefProbe, N, std::integer_sequence<int, N...>>::value || ...);
+
+/*
+ * @brief Stands in for `Temporaries` in constructions that bind none.
+ */
+struct NoTemporaries {};
+
+template <typename T, typename C, int... N>
+using TemporariesFor = std::conditional_t<BindsTemporaries<T, C, N...>, Temporaries, NoTemporaries>;
+
+inline Temporaries* temporariesOf(Temporaries& temporaries) { return &temporaries; }
+
+inline Temporaries* temporariesOf(NoTemporaries&) { return nullptr; }
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename C>
+Prefetch<T, C>::~Prefetch()
+{
+  if (!slots_) return;
+  for (int n = 0; n < count; ++n) {
+    if (slots_[n].value) slots_[n].destroy(slots_[n].value);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename C>
+template <int... N>
+Prefetch<T, C>* Prefetch<T, C>::start(std::integer_sequence<int, N...>)
+{
+  using Sequence = std::integer_sequence<int, N...>;
+  if constexpr (
+    !IsSame<C, Container> ||
+    sizeof...(N) < 2 ||
+    !std::is_constructible_v<T, PrefetchArg<T, N, C>...> ||
+    (AcceptsOpaqueAt<T, C, PrefetchArg, N, Sequence>::value || ...)) {
+    return nullptr;
+  }
+  else {
+    auto executor = ResolutionContext::executor();
+    if (!executor) return nullptr;
+    slots_ = std::make_unique<Slot[]>(count);
+    try {
+      (void)T(PrefetchArg<T, N, C>{ this }...);
+    }
+    catch (const Discovered&) {
+    }
+    ParallelTasks tasks(executor);
+    for (int n = 0; n < count; ++n) {
+      if (slots_[n].create) tasks.add([this, n]() { slots_[n].create(this, n); });
+    }
+    tasks.run();
+    return this;
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename C>
+template <typename U>
+void Prefetch<T, C>::discover(int n)
+{
+  if constexpr ((IsPointer<U> || IsVector<U>) && !IsSame<U, C*>) {
+    slots_[n].id = typeId<U>();
+    slots_[n].create = [](Prefetch* self, int n) {
+      auto step = self->plan_ ? self->plan_->step(n) : nullptr;
+      self->slots_[n].value = new U(self->container_->template createImpl<U>(self->args_, step));
+      self->slots_[n].destroy = [](void* value) { delete static_cast<U*>(value); };
+    };
+  }
+  if (++discovered_ == count) throw Discovered();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename C>
+template <typename U>
+U* Prefetch<T, C>::take(int n)
+{
+  auto& slot = slots_[n];
+  return slot.value && slot.id == typeId<U>() ? static_cast<U*>(slot.value) : nullptr;
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template<typename T>
-auto initPtr(T* obj, int) -> decltype(obj->init()) {
+auto initPtr(T* obj, int) -> decltype(obj->initAsync(), void()) {
+  ResolutionContext::defer(obj->initAsync());
+}
+
+template<typename T>
+auto initPtr(T* obj, long) -> decltype(obj->init()) {
   obj->init();
 }
 
@@ -75,13 +436,53 @@ void initPtr(T*, ...) { }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template<typename T>
-auto initCopy(T& obj, int) -> decltype(obj.init()) {
+auto initCopy(T& obj, int) -> decltype(obj.initAsync(), void()) {
+  obj.initAsync().get();
+}
+
+template<typename T>
+auto initCopy(T& obj, long) -> decltype(obj.init()) {
   obj.init();
 }
 
 template<typename T>
 void initCopy(T&, ...) { }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+constexpr bool HasInit = requires(T* obj) { obj->init(); } || requires(T* obj) { obj->initAsync(); };
+
+/*
+ * @brief Closes the frame of the object `ptr`, adding its initialization to the graph `createDeferred` builds.
+ */
+template <typename T>
+void deferInit(InitGraph::Frame& frame, T* ptr, bool callInit)
+{
+  if (callInit && HasInit<T>) frame.finish([ptr]() { initPtr(ptr, 0); }, typeName<T>());
+  else frame.finish();
+}
+
+/*
+ * @brief Creates an object with `construct` and initializes it, or defers its initialization to the graph being built.
+ *
+ * Only a `Container` builds init graphs, so objects created by other containers never look the graph up.
+ */
+template <typename C, typename F>
+auto constructAndInit(F construct, bool callInit)
+{
+  if constexpr (IsSame<C, Container>) {
+    if (InitGraph::current()) {
+      InitGraph::Frame frame;
+      auto ptr = construct();
+      deferInit(frame, &*ptr, callInit);
+      return ptr;
+    }
+  }
+  auto ptr = construct();
+  if (callInit) initPtr(&*ptr, 0);
+  return ptr;
+}
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T, typename U>
 struct ObjectFactoryPtrHelper;
@@ -89,12 +490,43 @@ struct ObjectFactoryPtrHelper;
 template <typename T, int... N>
 struct ObjectFactoryPtrHelper<T, std::integer_sequence<int, N...>>
 {
-  static T* createPtr(Container* container, Args* args, bool callInit) { 
-    (void)container;
-    (void)args;
-    T* ptr = new T(CtorArg<T, N>{ container, args }...);
-    if (callInit) initPtr(ptr, 0);
-    return ptr;
+  template <typename C>
+  static T* createPtr(C* container, Args* args, bool callInit, Plan<T>* plan) { 
+    return constructAndInit<C>([container, args, plan]() {
+      Prefetch<T, C> prefetch(container, args, plan);
+      [[maybe_unused]] auto prefetched = prefetch.start(std::integer_sequence<int, N...>());
+      [[maybe_unused]] TemporariesFor<T, C, N...> temporaries;
+      return new T(CtorArg<T, N, C>{ container, args, plan, prefetched, temporariesOf(temporaries) }...);
+    }, callInit);
+  }
+
+  template <typename C>
+  static std::shared_ptr<T> createShared(
+    C* container,
+    Args* args,
+    bool callInit,
+    Plan<T>* plan,
+    std::pmr::memory_resource* resource) {
+    return constructAndInit<C>([container, args, plan, resource]() {
+      Prefetch<T, C> prefetch(container, args, plan);
+      [[maybe_unused]] auto prefetched = prefetch.start(std::integer_sequence<int, N...>());
+      [[maybe_unused]] TemporariesFor<T, C, N...> temporaries;
+      return resource
+        ? std::allocate_shared<T>(
+            std::pmr::polymorphic_allocator<T>(resource),
+            CtorArg<T, N, C>{ container, args, plan, prefetched, temporariesOf(temporaries) }...)
+        : std::make_shared<T>(CtorArg<T, N, C>{ container, args, plan, prefetched, temporariesOf(temporaries) }...);
+    }, callInit);
+  }
+
+  template <typename C>
+  static T* createAt(void* place, C* container, Args* args, bool callInit, Plan<T>* plan) {
+    return constructAndInit<C>([place, container, args, plan]() {
+      Prefetch<T, C> prefetch(container, args, plan);
+      [[maybe_unused]] auto prefetched = prefetch.start(std::integer_sequence<int, N...>());
+      [[maybe_unused]] TemporariesFor<T, C, N...> temporaries;
+      return new (place) T(CtorArg<T, N, C>{ container, args, plan, prefetched, temporariesOf(temporaries) }...);
+    }, callInit);
   }
 };
 
@@ -105,29 +537,66 @@ struct ObjectFactoryHelper;
 template <typename T, int... N>
 struct ObjectFactoryHelper<T, std::integer_sequence<int, N...>>
 {
-  static T create(Container* container, Args* args, bool callInit) { 
-    (void)container;
-    (void)args;
-    T obj(CtorArg<T, N>{ container, args }...);
+  template <typename C>
+  static T create(C* container, Args* args, bool callInit) { 
+    auto construct = [container, args]() {
+      Prefetch<T, C> prefetch(container, args, nullptr);
+      [[maybe_unused]] auto prefetched = prefetch.start(std::integer_sequence<int, N...>());
+      [[maybe_unused]] TemporariesFor<T, C, N...> temporaries;
+      return T(CtorArg<T, N, C>{ container, args, nullptr, prefetched, temporariesOf(temporaries) }...);
+    };
+    if constexpr (IsSame<C, Container>) {
+      if (InitGraph::current()) {
+        InitGraph::Frame frame;
+        T obj = construct();
+        // a copy has no stable address to defer its initialization to, its dependencies are initialized first instead
+        if (callInit && HasInit<T>) frame.flush();
+        if (callInit) initCopy(obj, 0);
+        frame.finish();
+        return obj;
+      }
+    }
+    T obj = construct();
     if (callInit) initCopy(obj, 0);
     return obj;
   }
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
-template <typename T>
-T ObjectFactory::create(Container* container, Args* args, bool callInit)
+template <typename T, typename C>
+T ObjectFactory::create(C* container, Args* args, bool callInit)
 {
   using H = ObjectFactoryHelper<T, std::make_integer_sequence<int, countCtorArgs<T>(0)>>;
   return H::create(container, args, callInit);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
-template <typename T>
-T* ObjectFactory::createPtr(Container* container, Args* args, bool callInit)
+template <typename T, typename C>
+T* ObjectFactory::createPtr(C* container, Args* args, bool callInit, Plan<T>* plan)
+{
+  using H = ObjectFactoryPtrHelper<T, std::make_integer_sequence<int, countCtorArgs<T>(0)>>;
+  return H::createPtr(container, args, callInit, plan);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename C>
+std::shared_ptr<T> ObjectFactory::createShared(
+  C* container,
+  Args* args,
+  bool callInit,
+  Plan<T>* plan,
+  std::pmr::memory_resource* resource)
+{
+  using H = ObjectFactoryPtrHelper<T, std::make_integer_sequence<int, countCtorArgs<T>(0)>>;
+  return H::createShared(container, args, callInit, plan, resource);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename C>
+T* ObjectFactory::createAt(void* place, C* container, Args* args, bool callInit, Plan<T>* plan)
 {
   using H = ObjectFactoryPtrHelper<T, std::make_integer_sequence<int, countCtorArgs<T>(0)>>;
-  return H::createPtr(container, args, callInit);
+  return H::createAt(place, container, args, callInit, plan);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
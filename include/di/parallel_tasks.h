@@ -0,0 +1,106 @@
+#ifndef YAGA_DI_PARALLEL_TASKS
+#define YAGA_DI_PARALLEL_TASKS
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "di/resolution_context.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Independent resolutions run concurrently on the executor of `createParallel`.
+ *
+ * Every task is submitted to the executor, and the calling thread runs the tasks no worker has picked up yet itself,
+ * so the tasks complete even if the executor is busy, e.g. when it is a small pool running the parent resolution.
+ */
+class ParallelTasks
+{
+public:
+  explicit ParallelTasks(const ResolutionContext::Executor* executor) :
+    executor_(executor),
+    state_(std::make_shared<State>())
+  {
+    state_->keys = ResolutionContext::keys();
+  }
+
+  ParallelTasks(const ParallelTasks&) = delete;
+  ParallelTasks& operator=(const ParallelTasks&) = delete;
+
+  void add(std::function<void()> task) { state_->tasks.emplace_back(std::move(task)); }
+
+  /*
+   * @brief Runs all the tasks and waits for them, rethrowing the first exception.
+   */
+  inline void run();
+
+private:
+  struct Task
+  {
+    explicit Task(std::function<void()> function) : function(std::move(function)) {}
+    Task(Task&& other) : function(std::move(other.function)) {}
+
+    std::function<void()> function;
+    std::atomic<bool> claimed { false };
+  };
+
+  struct State
+  {
+    inline void run(std::size_t index, const ResolutionContext::Executor* executor);
+
+    std::vector<Task> tasks;
+    std::vector<const void*> keys;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t running = 0;
+    std::exception_ptr error;
+  };
+
+private:
+  const ResolutionContext::Executor* executor_;
+  std::shared_ptr<State> state_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void ParallelTasks::State::run(std::size_t index, const ResolutionContext::Executor* executor)
+{
+  if (tasks[index].claimed.exchange(true)) return;
+  try {
+    ResolutionContext::Parallel parallel(executor, keys);
+    tasks[index].function();
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (--running == 0) done.notify_all();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void ParallelTasks::run()
+{
+  auto state = state_;
+  state->running = state->tasks.size();
+  for (std::size_t i = 1; i < state->tasks.size(); ++i) {
+    (*executor_)([state, i, executor = executor_]() { state->run(i, executor); });
+  }
+  for (std::size_t i = 0; i < state->tasks.size(); ++i) {
+    state->run(i, executor_);
+  }
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done.wait(lock, [&state]() { return state->running == 0; });
+  if (state->error) std::rethrow_exception(state->error);
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_PARALLEL_TASKS
\ No newline at end of file
@@ -0,0 +1,263 @@
+#ifndef YAGA_DI_POOL
+#define YAGA_DI_POOL
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace yaga {
+namespace di {
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template<typename T>
+auto resetPtr(T* obj, int) -> decltype(obj->reset()) {
+  obj->reset();
+}
+
+template<typename T>
+void resetPtr(T*, ...) { }
+
+/*
+ * @brief Memory resource recycling blocks of a single size, meant for the control blocks of pooled shared pointers.
+ *
+ * The size of the first allocation is recycled, allocations of other sizes are passed to the upstream resource.
+ */
+class BlockResource : public std::pmr::memory_resource
+{
+public:
+  BlockResource() = default;
+  BlockResource(const BlockResource&) = delete;
+  BlockResource& operator=(const BlockResource&) = delete;
+  inline ~BlockResource();
+
+protected:
+  inline void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  inline void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+  std::mutex mutex_;
+  std::size_t bytes_ = 0;
+  std::size_t alignment_ = 0;
+  std::vector<void*> blocks_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BlockResource::~BlockResource()
+{
+  for (auto block : blocks_) {
+    std::pmr::new_delete_resource()->deallocate(block, bytes_, alignment_);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void* BlockResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!bytes_) {
+      bytes_ = bytes;
+      alignment_ = alignment;
+    }
+    if (bytes == bytes_ && alignment == alignment_ && !blocks_.empty()) {
+      auto block = blocks_.back();
+      blocks_.pop_back();
+      return block;
+    }
+  }
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void BlockResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bytes == bytes_ && alignment == alignment_) {
+      blocks_.push_back(ptr);
+      return;
+    }
+  }
+  std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+}
+
+/*
+ * @brief Pool of recycled instances of the class `T`.
+ *
+ * The storage for `capacity` instances is allocated up front. Released instances are reset and kept constructed on a
+ * free list, so acquiring one neither allocates nor resolves dependencies again. Instances that do not fit into the
+ * storage are allocated on the heap and deleted on release. All instances must be released before the pool is destroyed,
+ * see `PoolStorage`.
+ * An instance that has to be built from different arguments is constructed again in the storage of a released one.
+ */
+template <typename T>
+class Pool
+{
+public:
+  explicit Pool(std::size_t capacity);
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+  ~Pool();
+
+  /*
+   * @brief Returns a recycled instance, or constructs a new one calling `create` with the storage to construct it at.
+   *
+   * @param create A callable that accepts `void*` storage, or nullptr if the pool is full, and returns the instance.
+   * @param recycle Whether a released instance may be returned as is, otherwise it is destroyed and a new one is
+   * constructed in its storage.
+   */
+  template <typename F>
+  T* acquire(F create, bool recycle = true);
+
+  /*
+   * @brief Returns the instance to the pool, or deletes it if it was allocated on the heap.
+   */
+  void release(T* obj);
+
+private:
+  struct alignas(T) Slot
+  {
+    std::byte data[sizeof(T)];
+  };
+
+  bool owns(T* obj) const
+  {
+    auto slot = reinterpret_cast<const Slot*>(obj);
+    return slot >= slots_.get() && slot < slots_.get() + capacity_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::vector<void*> unused_;
+  std::vector<T*> released_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+Pool<T>::Pool(std::size_t capacity) :
+  capacity_(capacity),
+  slots_(new Slot[capacity])
+{
+  unused_.reserve(capacity);
+  released_.reserve(capacity);
+  for (std::size_t i = capacity; i > 0; --i) {
+    unused_.push_back(&slots_[i - 1]);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+Pool<T>::~Pool()
+{
+  for (auto obj : released_) {
+    obj->~T();
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+template <typename F>
+T* Pool<T>::acquire(F create, bool recycle)
+{
+  void* place = nullptr;
+  T* stale = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!released_.empty()) {
+      auto obj = released_.back();
+      released_.pop_back();
+      if (recycle) return obj;
+      stale = obj;
+    }
+    else if (!unused_.empty()) {
+      place = unused_.back();
+      unused_.pop_back();
+    }
+  }
+  if (stale) {
+    stale->~T();
+    place = stale;
+  }
+  try {
+    return create(place);
+  }
+  catch (...) {
+    if (place) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      unused_.push_back(place);
+    }
+    throw;
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+void Pool<T>::release(T* obj)
+{
+  if (!owns(obj)) {
+    delete obj;
+    return;
+  }
+  resetPtr(obj, 0);
+  std::lock_guard<std::mutex> lock(mutex_);
+  released_.push_back(obj);
+}
+
+/*
+ * @brief The pool of a `PoolFactory` together with the control blocks of its shared pointers.
+ *
+ * It is shared by the factory and every handed out instance, so it lives until the last of them is gone.
+ */
+template <typename T>
+struct PoolStorage
+{
+  explicit PoolStorage(std::size_t capacity) : pool(capacity) {}
+
+  Pool<T> pool;
+  BlockResource controlBlocks;
+};
+
+/*
+ * @brief Allocator of the control blocks of pooled shared pointers.
+ *
+ * It keeps the storage alive, so a control block is returned to a live resource even after the last instance is gone.
+ */
+template <typename U, typename T>
+class PoolAllocator
+{
+public:
+  using value_type = U;
+
+  explicit PoolAllocator(std::shared_ptr<PoolStorage<T>> storage) : storage_(std::move(storage)) {}
+
+  template <typename V>
+  PoolAllocator(const PoolAllocator<V, T>& other) : storage_(other.storage_) {}
+
+  U* allocate(std::size_t n)
+  {
+    return static_cast<U*>(storage_->controlBlocks.allocate(n * sizeof(U), alignof(U)));
+  }
+
+  void deallocate(U* ptr, std::size_t n) { storage_->controlBlocks.deallocate(ptr, n * sizeof(U), alignof(U)); }
+
+  template <typename V>
+  bool operator==(const PoolAllocator<V, T>& other) const { return storage_ == other.storage_; }
+
+private:
+  template <typename V, typename S>
+  friend class PoolAllocator;
+
+  std::shared_ptr<PoolStorage<T>> storage_;
+};
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_POOL
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef YAGA_DI_POOL_FACTORY
+#define YAGA_DI_POOL_FACTORY
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "di/factory.h"
+#include "di/object_factory.h"
+#include "di/pool.h"
+
+namespace yaga {
+namespace di {
+
+template <typename I, typename T>
+class PoolFactory : public Factory
+{
+public:
+  explicit PoolFactory(std::size_t capacity, bool callInit = false);
+
+protected:
+  void* createPure(Container* container, Args* args) override;
+
+  std::shared_ptr<void> createShared(Container* container, Args* args) override;
+
+  void* createUnique(Container* container, Args* args) override;
+
+  void* createReference(Container* container, Args* args) override;
+
+  bool allowInstanceCreation() override { return false; }
+
+  T* createInstance(Container* container, Args* args);
+
+protected:
+  std::shared_ptr<PoolStorage<T>> storage_;
+  Plan<T> plan_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+PoolFactory<I, T>::PoolFactory(std::size_t capacity, bool callInit) :
+  Factory(callInit),
+  storage_(std::make_shared<PoolStorage<T>>(capacity))
+{
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+T* PoolFactory<I, T>::createInstance(Container* container, Args* args)
+{
+  return storage_->pool.acquire([this, container, args](void* place) {
+    return place
+      ? ObjectFactory::createAt<T>(place, container, args, callInit_, &plan_)
+      : ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
+  }, !args || args->empty());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+void* PoolFactory<I, T>::createPure(Container*, Args*)
+{
+  throw std::runtime_error(std::string("Creating a raw pointer to ") + typeName<T>() + " is not allowed under the Pool Scope");
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<void> PoolFactory<I, T>::createShared(Container* container, Args* args)
+{
+  std::shared_ptr<I> ptr(
+    createInstance(container, args),
+    [storage = storage_](T* obj) { storage->pool.release(obj); },
+    PoolAllocator<std::byte, T>(storage_));
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+void* PoolFactory<I, T>::createUnique(Container*, Args*)
+{
+  throw std::runtime_error(std::string("Creating a unique pointer to ") + typeName<T>() + " is not allowed under the Pool Scope");
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+void* PoolFactory<I, T>::createReference(Container*, Args*)
+{
+  throw std::runtime_error(std::string("Creating a reference to ") + typeName<T>() + " is not allowed under the Pool Scope");
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_POOL_FACTORY
\ No newline at end of file
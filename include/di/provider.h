@@ -0,0 +1,66 @@
+#ifndef YAGA_DI_PROVIDER_H
+#define YAGA_DI_PROVIDER_H
+
+#include <utility>
+
+#include "di/args.h"
+#include "di/factory.h"
+
+namespace yaga {
+namespace di {
+
+class Container;
+
+/*
+ * @brief Injectable handle creating objects of the type `T` on demand.
+ *
+ * The factory of `T` is looked up once, when the provider is created, and each call creates the object directly from
+ * that factory, which replays its own dependency plan. Unlike a `std::function`, a call does not look the type up in
+ * the container and involves no type-erased function object. The container must outlive the provider.
+ *
+ * @tparam T The type of the created objects, e.g. `Service*`, `std::shared_ptr<Service>` or `std::unique_ptr<Service>`.
+ */
+template <typename T>
+class Provider
+{
+public:
+  using ResultType = T;
+
+  Provider() : container_(nullptr), factory_(nullptr) {}
+
+  Provider(Container* container, Factory* factory) : container_(container), factory_(factory) {}
+
+  /*
+   * @brief Creates an object of the type `T`, resolving dependencies.
+   *
+   * @param params The runtime arguments passed to the constructors, see `Container::create`.
+   * @return T The created object.
+   */
+  template <typename... Params>
+  T operator()(Params&&... params) const;
+
+  explicit operator bool() const { return factory_ != nullptr; }
+
+private:
+  Container* container_;
+  Factory* factory_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+template <typename... Params>
+T Provider<T>::operator()(Params&&... params) const
+{
+  if constexpr (sizeof...(Params) == 0) {
+    return factory_->template createObject<T>(container_, nullptr);
+  }
+  else {
+    ArgsArray args(std::forward<Params>(params)...);
+    return factory_->template createObject<T>(container_, &args);
+  }
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_PROVIDER_H
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef YAGA_DI_REF_H
+#define YAGA_DI_REF_H
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Injectable non-owning reference to a shared instance held by the container.
+ *
+ * Only registrations with SharedScope or SharedImlpScope can be referenced. The instance lives as long as the container,
+ * so the reference does not share its ownership and resolving it does not touch the reference counter.
+ *
+ * @tparam T The type of the referenced instance.
+ */
+template <typename T>
+class Ref
+{
+public:
+  Ref() : ptr_(nullptr) {}
+
+  explicit Ref(T* ptr) : ptr_(ptr) {}
+
+  T* get() const { return ptr_; }
+
+  T& operator*() const { return *ptr_; }
+
+  T* operator->() const { return ptr_; }
+
+  explicit operator bool() const { return ptr_ != nullptr; }
+
+private:
+  T* ptr_;
+};
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_REF_H
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef YAGA_DI_REGISTRY
+#define YAGA_DI_REGISTRY
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+#include "di/type_id.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Table of pointers indexed by `TypeId` that can be read without locking.
+ *
+ * The table grows in segments of doubling size which are never moved or released before the table itself, so a reader
+ * only performs two acquire loads. Writers must be serialized by the caller, the table does not own the stored values.
+ *
+ * @tparam V The type of the stored values.
+ */
+template <typename V>
+class Registry
+{
+public:
+  Registry() = default;
+  Registry(const Registry&) = delete;
+  Registry& operator=(const Registry&) = delete;
+  ~Registry();
+
+  /*
+   * @brief Returns the value stored for the identifier `id`, or nullptr if there is none.
+   */
+  V* find(TypeId id) const;
+
+  /*
+   * @brief Stores the value for the identifier `id`, allocating the segment if needed.
+   */
+  void set(TypeId id, V* value);
+
+private:
+  using Slot = std::atomic<V*>;
+
+  static constexpr std::size_t firstSegmentSize = 64;
+  static constexpr std::size_t segmentCount = 32;
+
+  static std::size_t segmentIndex(TypeId id) { return std::bit_width(id / firstSegmentSize + 1) - 1; }
+
+  static std::size_t segmentBegin(std::size_t segment) { return firstSegmentSize * ((std::size_t(1) << segment) - 1); }
+
+  static std::size_t segmentSize(std::size_t segment) { return firstSegmentSize << segment; }
+
+private:
+  std::array<std::atomic<Slot*>, segmentCount> segments_ {};
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename V>
+Registry<V>::~Registry()
+{
+  for (auto& segment : segments_) {
+    delete[] segment.load(std::memory_order_relaxed);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename V>
+V* Registry<V>::find(TypeId id) const
+{
+  auto index = segmentIndex(id);
+  if (index >= segmentCount) return nullptr;
+  auto segment = segments_[index].load(std::memory_order_acquire);
+  return segment ? segment[id - segmentBegin(index)].load(std::memory_order_acquire) : nullptr;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename V>
+void Registry<V>::set(TypeId id, V* value)
+{
+  auto index = segmentIndex(id);
+  auto segment = segments_[index].load(std::memory_order_relaxed);
+  if (!segment) {
+    segment = new Slot[segmentSize(index)]();
+    segments_[index].store(segment, std::memory_order_release);
+  }
+  segment[id - segmentBegin(index)].store(value, std::memory_order_release);
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_REGISTRY
\ No newline at end of file
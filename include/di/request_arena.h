@@ -0,0 +1,114 @@
+#ifndef YAGA_DI_REQUEST_ARENA
+#define YAGA_DI_REQUEST_ARENA
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Bump allocator owning the objects created within a `RequestScope`.
+ *
+ * Objects are allocated from a monotonic buffer and recorded in an intrusive list, which is walked in reverse creation
+ * order when the arena is destroyed. The arena becomes the current arena of the thread while a resolution runs within
+ * its scope, so the UniqueScope factories can place the objects requested as raw pointers into it.
+ */
+class RequestArena
+{
+public:
+  RequestArena() = default;
+  RequestArena(void* buffer, std::size_t size) : resource_(buffer, size) {}
+  RequestArena(const RequestArena&) = delete;
+  RequestArena& operator=(const RequestArena&) = delete;
+  inline ~RequestArena();
+
+  /*
+   * @brief Constructs an object of the class `T` in the arena.
+   *
+   * @param create A callable that accepts `void*` storage and constructs the object at it.
+   */
+  template <typename T, typename F>
+  T* create(F create);
+
+  /*
+   * @brief Takes over the ownership of an object allocated with `new`, it is deleted together with the arena.
+   */
+  template <typename T>
+  T* adopt(T* obj);
+
+  /*
+   * @brief Suspends the current arena of the thread for the lifetime of the object.
+   *
+   * Instances which outlive the request, e.g. shared or pooled ones, are created under a suspension, so that neither
+   * they nor their dependencies are placed into the arena.
+   */
+  class Suspension
+  {
+  public:
+    Suspension() : previous_(current()) { current() = nullptr; }
+    Suspension(const Suspension&) = delete;
+    Suspension& operator=(const Suspension&) = delete;
+    ~Suspension() { current() = previous_; }
+
+  private:
+    RequestArena* previous_;
+  };
+
+  /*
+   * @brief Returns the arena of the scope the current thread resolves objects in, or nullptr.
+   */
+  static RequestArena*& current()
+  {
+    thread_local RequestArena* arena = nullptr;
+    return arena;
+  }
+
+private:
+  struct Node
+  {
+    void (*destroy)(void*);
+    void* obj;
+    Node* next;
+  };
+
+  void push(void (*destroy)(void*), void* obj)
+  {
+    head_ = new (resource_.allocate(sizeof(Node), alignof(Node))) Node { destroy, obj, head_ };
+  }
+
+private:
+  std::pmr::monotonic_buffer_resource resource_;
+  Node* head_ = nullptr;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+RequestArena::~RequestArena()
+{
+  for (auto node = head_; node; node = node->next) {
+    node->destroy(node->obj);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename F>
+T* RequestArena::create(F create)
+{
+  void* place = resource_.allocate(sizeof(T), alignof(T));
+  T* obj = create(place);
+  push([](void* ptr) { static_cast<T*>(ptr)->~T(); }, obj);
+  return obj;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+T* RequestArena::adopt(T* obj)
+{
+  push([](void* ptr) { delete static_cast<T*>(ptr); }, obj);
+  return obj;
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_REQUEST_ARENA
\ No newline at end of file
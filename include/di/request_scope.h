@@ -0,0 +1,90 @@
+#ifndef YAGA_DI_REQUEST_SCOPE_H
+#define YAGA_DI_REQUEST_SCOPE_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "di/container.h"
+#include "di/request_arena.h"
+
+namespace yaga {
+namespace di {
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class RequestScope
+{
+public:
+  /*
+   * @brief Creates a scope whose UniqueScope objects are owned by a per-request arena.
+   *
+   * UniqueScope objects created through the scope as raw pointers, including their UniqueScope dependencies requested
+   * as raw pointers, are bump-allocated in the arena and destroyed in reverse creation order when the scope ends, so
+   * such classes must not take over the ownership of their raw pointer dependencies. Shared and unique pointers, copies
+   * and the instances of the other scopes, together with all their dependencies, are created as usual. Creating the
+   * scope does not allocate.
+   *
+   * @param container The container the objects are created from, it must outlive the scope.
+   */
+  explicit RequestScope(Container& container) : container_(&container) {}
+
+  /*
+   * @brief Creates a scope whose arena starts with the buffer `buffer`, e.g. a buffer on the stack.
+   *
+   * @see RequestScope
+   */
+  RequestScope(Container& container, void* buffer, std::size_t size) : container_(&container), arena_(buffer, size) {}
+
+  RequestScope(const RequestScope&) = delete;
+  RequestScope& operator=(const RequestScope&) = delete;
+
+  /*
+   * @brief Creates an instance of the class `T` within the scope, resolving dependencies.
+   *
+   * @tparam T The class type to be created.
+   * @param params The runtime arguments passed to the constructors, see `Container::create`.
+   * @return T An instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  T create(Params&&... params);
+
+  /*
+   * @brief Creates a pointer to and instance of the class `T` owned by the scope, resolving dependencies.
+   *
+   * @tparam T The class type for which a pointer will be created.
+   * @return T* A pointer to an instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  T* createPtr(Params&&... params) { return create<T*>(std::forward<Params>(params)...); }
+
+  /*
+   * @brief Creates a shared pointer to and instance of the class `T` within the scope, resolving dependencies.
+   *
+   * @tparam T The class type for which a shared pointer will be created.
+   * @return std::shared_ptr<T> A shared pointer to an instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  std::shared_ptr<T> createShared(Params&&... params) { return create<std::shared_ptr<T>>(std::forward<Params>(params)...); }
+
+private:
+  Container* container_;
+  RequestArena arena_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename... Params>
+T RequestScope::create(Params&&... params)
+{
+  struct Activation
+  {
+    explicit Activation(RequestArena* arena) : previous(RequestArena::current()) { RequestArena::current() = arena; }
+    ~Activation() { RequestArena::current() = previous; }
+    RequestArena* previous;
+  } activation(&arena_);
+  return container_->create<T>(std::forward<Params>(params)...);
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_REQUEST_SCOPE_H
\ No newline at end of file
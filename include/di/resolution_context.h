@@ -0,0 +1,246 @@
+#ifndef YAGA_DI_RESOLUTION_CONTEXT
+#define YAGA_DI_RESOLUTION_CONTEXT
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Per-thread record of the instances being constructed by the current resolution.
+ *
+ * Nested resolutions on the same thread, e.g. a factory functor called from a constructor or an `init` method, share the
+ * record. It lets them detect a re-entry into an instance this thread is already constructing, which would otherwise
+ * block forever on the instance lock. It also collects the asynchronous `initAsync` calls started by `createAsync`
+ * and carries the executor of `createParallel`.
+ */
+class ResolutionContext
+{
+public:
+  /*
+   * @brief Marks the instance identified by `key` as being constructed by this thread for the lifetime of the guard.
+   */
+  class Guard
+  {
+  public:
+    explicit Guard(const void* key) { stack().push_back(key); }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard() { stack().pop_back(); }
+  };
+
+  /*
+   * @brief Initializations of a resolution which are still in progress, innermost on this thread for its lifetime.
+   *
+   * Shared instances created by the resolution are not published to other threads until the initializations started
+   * during their creation are over, those threads wait for them instead. Once the resolution is over, the callbacks
+   * publish the instances, or reset them if an initialization failed, so that they are created again.
+   */
+  class Settlement
+  {
+  public:
+    Settlement() : previous_(settlement()) { settlement() = this; }
+    Settlement(const Settlement&) = delete;
+    Settlement& operator=(const Settlement&) = delete;
+    ~Settlement() { leave(); settle(false); }
+
+    /*
+     * @brief Stops being the innermost settlement of this thread.
+     */
+    void leave()
+    {
+      if (active_) settlement() = previous_;
+      active_ = false;
+    }
+
+    void add(std::shared_future<void> future) { futures_.push_back(std::move(future)); }
+
+    std::size_t size() const { return futures_.size(); }
+
+    /*
+     * @brief Returns the initializations added after the first `first` ones.
+     */
+    std::vector<std::shared_future<void>> since(std::size_t first) const
+    {
+      return std::vector<std::shared_future<void>>(futures_.begin() + first, futures_.end());
+    }
+
+    void onSettled(std::function<void(bool)> callback) { callbacks_.push_back(std::move(callback)); }
+
+    /*
+     * @brief Runs the callbacks once, `succeeded` tells whether all the initializations succeeded.
+     */
+    void settle(bool succeeded)
+    {
+      auto callbacks = std::move(callbacks_);
+      callbacks_.clear();
+      for (auto& callback : callbacks) {
+        callback(succeeded);
+      }
+    }
+
+  protected:
+    std::vector<std::shared_future<void>> futures_;
+
+  private:
+    std::vector<std::function<void(bool)>> callbacks_;
+    Settlement* previous_;
+    bool active_ = true;
+  };
+
+  /*
+   * @brief Collects the asynchronous initializations started on this thread for the lifetime of the object.
+   */
+  class PendingInits : public Settlement
+  {
+  public:
+    PendingInits() : previous_(pending()) { pending() = this; }
+    inline ~PendingInits();
+
+    /*
+     * @brief Waits for all the collected initializations, rethrowing the first exception.
+     */
+    inline void wait();
+
+  private:
+    PendingInits* previous_;
+  };
+
+  using Executor = std::function<void(std::function<void()>)>;
+
+  /*
+   * @brief Resolves the independent dependencies on the executor `executor` for the lifetime of the object.
+   *
+   * The keys of the instances being constructed by the parent resolution are inherited, so that a task re-entering one
+   * of them throws instead of waiting for the parent forever.
+   */
+  class Parallel
+  {
+  public:
+    inline Parallel(const Executor* executor, const std::vector<const void*>& keys);
+    Parallel(const Parallel&) = delete;
+    Parallel& operator=(const Parallel&) = delete;
+    inline ~Parallel();
+
+  private:
+    const Executor* previous_;
+    std::size_t count_;
+  };
+
+  /*
+   * @brief Returns the executor of the innermost `Parallel` of this thread, or nullptr if there is none.
+   */
+  static const Executor* executor() { return parallel(); }
+
+  /*
+   * @brief Returns the keys of the instances being constructed by this thread.
+   */
+  static std::vector<const void*> keys() { return stack(); }
+
+  /*
+   * @brief Hands over an asynchronous initialization to the innermost `PendingInits` of this thread.
+   *
+   * If there is none, the initialization is waited for immediately.
+   */
+  static void defer(std::future<void> future)
+  {
+    if (auto inits = pending()) inits->add(future.share());
+    else future.get();
+  }
+
+  /*
+   * @brief Returns the innermost `Settlement` of this thread, or nullptr if there is none.
+   */
+  static Settlement* current() { return settlement(); }
+
+  /*
+   * @brief Checks whether the instance identified by `key` is being constructed by this thread.
+   */
+  static bool constructing(const void* key)
+  {
+    auto& keys = stack();
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+  }
+
+  /*
+   * @brief Returns the number of instances being constructed by this thread.
+   */
+  static std::size_t depth() { return stack().size(); }
+
+private:
+  static std::vector<const void*>& stack()
+  {
+    thread_local std::vector<const void*> keys;
+    return keys;
+  }
+
+  static PendingInits*& pending()
+  {
+    thread_local PendingInits* inits = nullptr;
+    return inits;
+  }
+
+  static Settlement*& settlement()
+  {
+    thread_local Settlement* settlement = nullptr;
+    return settlement;
+  }
+
+  static const Executor*& parallel()
+  {
+    thread_local const Executor* executor = nullptr;
+    return executor;
+  }
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+ResolutionContext::Parallel::Parallel(const Executor* executor, const std::vector<const void*>& keys) :
+  previous_(parallel()),
+  count_(keys.size())
+{
+  parallel() = executor;
+  stack().insert(stack().end(), keys.begin(), keys.end());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+ResolutionContext::Parallel::~Parallel()
+{
+  stack().resize(stack().size() - count_);
+  parallel() = previous_;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+ResolutionContext::PendingInits::~PendingInits()
+{
+  pending() = previous_;
+  for (auto& future : futures_) {
+    future.wait();
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void ResolutionContext::PendingInits::wait()
+{
+  std::exception_ptr error;
+  for (auto& future : futures_) {
+    try {
+      future.get();
+    }
+    catch (...) {
+      if (!error) error = std::current_exception();
+    }
+  }
+  futures_.clear();
+  settle(!error);
+  if (error) std::rethrow_exception(error);
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_RESOLUTION_CONTEXT
\ No newline at end of file
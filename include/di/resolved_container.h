@@ -0,0 +1,74 @@
+#ifndef YAGA_DI_RESOLVED_CONTAINER_H
+#define YAGA_DI_RESOLVED_CONTAINER_H
+
+#include <memory>
+#include <utility>
+
+#include "di/container.h"
+
+namespace yaga {
+namespace di {
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class ResolvedContainer
+{
+public:
+  /*
+   * @brief Creates a view of a frozen container.
+   *
+   * @param container The container the objects are created from, it must outlive the view.
+   */
+  explicit ResolvedContainer(Container* container) : container_(container) {}
+
+  /*
+   * @brief Creates an instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type to be created.
+   * @param params The runtime arguments passed to the constructors, see `Container::create`.
+   * @return T An instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  T create(Params&&... params) const { return container_->create<T>(std::forward<Params>(params)...); }
+
+  /*
+   * @brief Creates a pointer to and instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type for which a pointer will be created.
+   * @return T* A pointer to an instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  T* createPtr(Params&&... params) const { return container_->createPtr<T>(std::forward<Params>(params)...); }
+
+  /*
+   * @brief Creates a shared pointer to and instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type for which a shared pointer will be created.
+   * @return std::shared_ptr<T> A shared pointer to an instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  std::shared_ptr<T> createShared(Params&&... params) const { return container_->createShared<T>(std::forward<Params>(params)...); }
+
+  /*
+   * @brief Creates a unique pointer to and instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type for which a unique pointer will be created.
+   * @return std::unique_ptr<T> A unique pointer to an instance of the class `T`.
+   */
+  template <typename T, typename... Params>
+  std::unique_ptr<T> createUnique(Params&&... params) const { return container_->createUnique<T>(std::forward<Params>(params)...); }
+
+  /*
+   * @brief Returns the frozen container the view was created from.
+   *
+   * @return Container& The underlying container.
+   */
+  Container& container() const { return *container_; }
+
+private:
+  Container* container_;
+};
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_RESOLVED_CONTAINER_H
\ No newline at end of file
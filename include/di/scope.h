@@ -1,6 +1,9 @@
 #ifndef YAGA_DI_SCOPE_H
 #define YAGA_DI_SCOPE_H
 
+#include <cstddef>
+#include <type_traits>
+
 namespace yaga {
 namespace di {
 
@@ -35,6 +38,38 @@ struct SharedScope : public Scope {};
  */
 struct SharedImlpScope : public Scope {};
 
+/**
+ * @brief Scope that provides a separate instance of an object to every thread.
+ *
+ * The `ThreadScope` specifies that the `create` method will return the same instance of
+ * a given class type each time it is called from the same thread, while different threads
+ * get distinct instances. It suits stateful helpers which are not thread-safe, such as
+ * serializers or random number generators. The instances are destroyed when their thread exits.
+ */
+struct ThreadScope : public Scope {};
+
+/**
+ * @brief Scope that recycles the instances of an object through a pool.
+ *
+ * The `PoolScope` specifies that the `create` method will return a `std::shared_ptr` to an
+ * instance taken from a pool with storage reserved for `Capacity` instances, which are
+ * constructed on first use. When the last owner releases it, the `reset` method is called
+ * if it's defined and the instance is returned to the pool to be handed out again without
+ * being constructed. When the pool is exhausted, instances are allocated on the heap and
+ * deleted on release.
+ */
+template <std::size_t Capacity>
+struct PoolScope : public Scope {};
+
+template <typename S>
+struct PoolScopeTraits : std::false_type {};
+
+template <std::size_t Capacity>
+struct PoolScopeTraits<PoolScope<Capacity>> : std::true_type
+{
+  static constexpr std::size_t capacity = Capacity;
+};
+
 } // !namespace di
 } // !namespace yaga
 
@@ -5,6 +5,7 @@
 
 #include "di/factory.h"
 #include "di/object_factory.h"
+#include "di/shared_instance.h"
 
 namespace yaga {
 namespace di {
@@ -26,12 +27,21 @@ protected:
 
   bool allowInstanceCreation() override { return false; }
 
-  std::shared_ptr<T> getInstance(Container* container, Args* args);
+  bool holdsInstance() override { return true; }
+
+  bool warmup(Container* container) override { return getInstance(container, nullptr) != nullptr; }
+
+  const void* instanceKey() const override { return &instance_; }
+
+  const std::shared_ptr<T>& getInstance(Container* container, Args* args);
 
   virtual T* createInstance(Container* container, Args* args);
 
+  virtual std::shared_ptr<T> createSharedInstance(Container* container, Args* args);
+
 protected:
-  std::shared_ptr<T> instance_;
+  SharedInstance<T> instance_;
+  Plan<T> plan_;
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -46,17 +56,23 @@ SharedFactory<I, T>::SharedFactory(bool callInit, std::shared_ptr<T> instance) :
 template <typename I, typename T>
 T* SharedFactory<I, T>::createInstance(Container* container, Args* args)
 {
-  return ObjectFactory::createPtr<T>(container, args, callInit_);
+  return ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<T> SharedFactory<I, T>::createSharedInstance(Container* container, Args* args)
+{
+  return ObjectFactory::createShared<T>(container, args, callInit_, &plan_, resource(container));
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename I, typename T>
-std::shared_ptr<T> SharedFactory<I, T>::getInstance(Container* container, Args* args)
+const std::shared_ptr<T>& SharedFactory<I, T>::getInstance(Container* container, Args* args)
 {
-  if (!instance_) {
-    instance_ = std::shared_ptr<T>(createInstance(container, args));
-  }
-  return instance_;
+  return instance_.get([this, container, args]() {
+    return createSharedInstance(container, args);
+  });
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -79,7 +95,7 @@ std::shared_ptr<void> SharedFactory<I, T>::createShared(Container* container, Ar
 template <typename I, typename T>
 void* SharedFactory<I, T>::createUnique(Container* container, Args* args)
 {
-  I* ptr = ObjectFactory::createPtr<T>(container, args, callInit_);
+  I* ptr = ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
   return ptr;
 }
 
@@ -17,6 +17,8 @@ public:
 protected:
   virtual T* createInstance(Container* container, Args* args);
 
+  std::shared_ptr<T> createSharedInstance(Container* container, Args* args) override;
+
 private:
   F functor_;
 };
@@ -35,6 +37,13 @@ T* SharedFunctorFactory<I, T, F>::createInstance(Container* container, Args*)
   return FunctorInvoker::invoke<F>(functor_, container);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+std::shared_ptr<T> SharedFunctorFactory<I, T, F>::createSharedInstance(Container* container, Args* args)
+{
+  return std::shared_ptr<T>(this->createInstance(container, args));
+}
+
 } // !namespace di
 } // !namespace yaga
 
@@ -1,22 +1,16 @@
 #ifndef YAGA_DI_SHARED_IMPL_FACTORY
 #define YAGA_DI_SHARED_IMPL_FACTORY
 
-#include <unordered_map>
 #include <memory>
 
 #include "di/factory.h"
 #include "di/factory_context.h"
 #include "di/object_factory.h"
+#include "di/shared_instance.h"
 
 namespace yaga {
 namespace di {
 
-// -----------------------------------------------------------------------------------------------------------------------------
-struct SharedImlpFactoryContext
-{
-  std::unordered_map<std::type_index, std::shared_ptr<void>> instances;
-};
-
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename I, typename T>
 class SharedImlpFactory : public Factory
@@ -35,41 +29,55 @@ protected:
 
   bool allowInstanceCreation() override { return false; }
 
-  std::shared_ptr<T> getInstance(Container* container, Args* args);
+  bool holdsInstance() override { return true; }
+
+  bool warmup(Container* container) override { return getInstance(container, nullptr) != nullptr; }
+
+  const void* instanceKey() const override { return instance_; }
+
+  const std::shared_ptr<T>& getInstance(Container* container, Args* args);
 
   virtual T* createInstance(Container* container, Args* args);
 
+  virtual std::shared_ptr<T> createSharedInstance(Container* container, Args* args);
+
 protected:
-  SharedImlpFactoryContext* context_;
+  SharedInstance<T>* instance_;
+  Plan<T> plan_;
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename I, typename T>
 SharedImlpFactory<I, T>::SharedImlpFactory(FactoryContext* context, bool callInit, std::shared_ptr<T> instance) :
   Factory(callInit),
-  context_(context->get<SharedImlpFactoryContext>()) 
+  instance_(context->get<SharedInstance<T>>())
 {
   if (instance) {
-    context_->instances[typeid(T)] = instance;
+    instance_->set(instance);
   }
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename I, typename T>
-std::shared_ptr<T> SharedImlpFactory<I, T>::getInstance(Container* container, Args* args)
+const std::shared_ptr<T>& SharedImlpFactory<I, T>::getInstance(Container* container, Args* args)
 {
-  auto it = context_->instances.find(typeid(T));
-  if (it != context_->instances.end() && it->second) return std::static_pointer_cast<T>(it->second);
-  auto instance = std::shared_ptr<T>(createInstance(container, args));
-  context_->instances[typeid(T)] = instance;
-  return std::static_pointer_cast<T>(instance);
+  return instance_->get([this, container, args]() {
+    return createSharedInstance(container, args);
+  });
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename I, typename T>
 T* SharedImlpFactory<I, T>::createInstance(Container* container, Args* args)
 {
-  return ObjectFactory::createPtr<T>(container, args, callInit_);
+  return ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<T> SharedImlpFactory<I, T>::createSharedInstance(Container* container, Args* args)
+{
+  return ObjectFactory::createShared<T>(container, args, callInit_, &plan_, resource(container));
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -92,7 +100,7 @@ std::shared_ptr<void> SharedImlpFactory<I, T>::createShared(Container* container
 template <typename I, typename T>
 void* SharedImlpFactory<I, T>::createUnique(Container* container, Args* args)
 {
-  I* ptr = ObjectFactory::createPtr<T>(container, args, callInit_);
+  I* ptr = ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
   return ptr;
 }
 
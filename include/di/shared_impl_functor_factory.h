@@ -17,6 +17,8 @@ public:
 protected:
   T* createInstance(Container* container, Args* args) override;
 
+  std::shared_ptr<T> createSharedInstance(Container* container, Args* args) override;
+
 protected:
   F functor_;
 };
@@ -35,6 +37,13 @@ T* SharedImlpFunctorFactory<I, T, F>::createInstance(Container* container, Args*
   return FunctorInvoker::invoke<F>(functor_, container);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+std::shared_ptr<T> SharedImlpFunctorFactory<I, T, F>::createSharedInstance(Container* container, Args* args)
+{
+  return std::shared_ptr<T>(this->createInstance(container, args));
+}
+
 } // !namespace di
 } // !namespace yaga
 
@@ -0,0 +1,157 @@
+#ifndef YAGA_DI_SHARED_INSTANCE
+#define YAGA_DI_SHARED_INSTANCE
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "di/init_graph.h"
+#include "di/request_arena.h"
+#include "di/resolution_context.h"
+#include "di/type_id.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Holds a lazily created shared instance.
+ *
+ * Only the first creation is synchronized, once the instance is published it is read without taking the lock.
+ * Requesting the instance again from the thread that is creating it throws instead of blocking on the lock.
+ * An instance whose initialization is still in progress is only handed out to the resolution that created it, other
+ * resolutions wait for the initialization and create the instance again if it failed. `Deferrable` instances take part
+ * in the init graph of `createDeferred`, which only a `Container` builds.
+ */
+template <typename T, bool Deferrable = true>
+class SharedInstance
+{
+public:
+  explicit SharedInstance(std::shared_ptr<T> instance = nullptr);
+
+  template <typename F>
+  const std::shared_ptr<T>& get(F create);
+
+  void set(std::shared_ptr<T> instance);
+
+private:
+  void hold(ResolutionContext::Settlement* settlement, std::size_t first);
+  void await(std::unique_lock<std::mutex>& lock);
+  void settle(bool succeeded);
+
+private:
+  std::mutex mutex_;
+  std::atomic<bool> created_;
+  std::shared_ptr<T> instance_;
+  ResolutionContext::Settlement* owner_ = nullptr;
+  std::vector<std::shared_future<void>> pending_;
+  std::size_t attempt_ = 0;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool Deferrable>
+SharedInstance<T, Deferrable>::SharedInstance(std::shared_ptr<T> instance) :
+  created_(instance != nullptr),
+  instance_(instance)
+{
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool Deferrable>
+template <typename F>
+const std::shared_ptr<T>& SharedInstance<T, Deferrable>::get(F create)
+{
+  if (!created_.load(std::memory_order_acquire)) {
+    if (ResolutionContext::constructing(this)) {
+      throw std::runtime_error(std::string("Circular dependency on class ") + typeName<T>());
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (owner_ && owner_ != ResolutionContext::current()) await(lock);
+    if (!instance_) {
+      ResolutionContext::Guard guard(this);
+      RequestArena::Suspension suspension;
+      auto settlement = ResolutionContext::current();
+      auto first = settlement ? settlement->size() : 0;
+      if constexpr (Deferrable) {
+        InitGraph::Frame frame;
+        instance_ = create();
+        if (auto node = frame.finish()) InitGraph::current()->bind(this, node);
+      }
+      else {
+        instance_ = create();
+      }
+      if (settlement && settlement->size() > first) hold(settlement, first);
+      else created_.store(true, std::memory_order_release);
+      return instance_;
+    }
+  }
+  if constexpr (Deferrable) {
+    if (auto graph = InitGraph::current()) graph->reuse(this);
+  }
+  return instance_;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool Deferrable>
+void SharedInstance<T, Deferrable>::set(std::shared_ptr<T> instance)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  instance_ = instance;
+  owner_ = nullptr;
+  pending_.clear();
+  ++attempt_;
+  created_.store(instance_ != nullptr, std::memory_order_release);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool Deferrable>
+void SharedInstance<T, Deferrable>::hold(ResolutionContext::Settlement* settlement, std::size_t first)
+{
+  owner_ = settlement;
+  pending_ = settlement->since(first);
+  settlement->onSettled([this, attempt = ++attempt_](bool succeeded) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (attempt_ == attempt) settle(succeeded);
+  });
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool Deferrable>
+void SharedInstance<T, Deferrable>::await(std::unique_lock<std::mutex>& lock)
+{
+  while (owner_ && owner_ != ResolutionContext::current()) {
+    auto pending = pending_;
+    auto attempt = attempt_;
+    lock.unlock();
+    bool succeeded = true;
+    for (auto& future : pending) {
+      try {
+        future.get();
+      }
+      catch (...) {
+        succeeded = false;
+      }
+    }
+    lock.lock();
+    if (attempt_ == attempt) settle(succeeded);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool Deferrable>
+void SharedInstance<T, Deferrable>::settle(bool succeeded)
+{
+  if (succeeded) created_.store(true, std::memory_order_release);
+  else instance_.reset();
+  owner_ = nullptr;
+  pending_.clear();
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_SHARED_INSTANCE
\ No newline at end of file
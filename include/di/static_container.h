@@ -0,0 +1,387 @@
+#ifndef YAGA_DI_STATIC_CONTAINER_H
+#define YAGA_DI_STATIC_CONTAINER_H
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "di/container.h"
+#include "di/object_factory.h"
+#include "di/scope.h"
+#include "di/shared_instance.h"
+#include "di/type_traits.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Binding of the class `T` to the interface `I` in a `StaticContainer`.
+ *
+ * @tparam I The interface type under which the class `T` is bound.
+ * @tparam T The class type being bound, which must be derived from `I`.
+ * @tparam S The scope type of the binding. Possible values: UniqueScope, SharedScope, SharedImlpScope.
+ * @tparam CallInit A boolean flag indicating whether to call the `init` method of `T` during instantiation.
+ */
+template <typename I, typename T = I, typename S = UniqueScope, bool CallInit = false>
+struct Bind
+{
+  static_assert(IsBaseOf<I, T, S>, "T must be derived from I");
+  static_assert(
+    IsSame<S, UniqueScope> || IsSame<S, SharedScope> || IsSame<S, SharedImlpScope>,
+    "Scope is not supported by StaticContainer");
+
+  using Interface = RemoveCVRef<I>;
+  using Type = T;
+  using Scope = S;
+  static constexpr bool callInit = CallInit;
+  static constexpr bool multi = false;
+};
+
+/*
+ * @brief Binding of one of the classes resolved for `std::vector<I>` in a `StaticContainer`.
+ *
+ * @see Bind
+ */
+template <typename I, typename T = I, typename S = UniqueScope, bool CallInit = false>
+struct BindMulti : Bind<I, T, S, CallInit>
+{
+  static constexpr bool multi = true;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+constexpr bool AlwaysFalse = false;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T, bool = IsPointer<T> || IsReference<T>>
+struct StaticElement
+{
+  using Type = RemoveCVRef<T>;
+};
+
+template <typename T>
+struct StaticElement<T, true>
+{
+  using Type = typename PointerTraits<T>::ElementType;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct StaticUniqueSlot {};
+
+template <typename B>
+using StaticSlot = std::conditional_t<
+  IsSame<typename B::Scope, UniqueScope>,
+  StaticUniqueSlot,
+  SharedInstance<typename B::Type, false>>;
+
+/*
+ * @brief Dependency injection container whose bindings are resolved at compile time.
+ *
+ * Bindings are declared as a type list, either directly or by chaining `add` and `addMulti` calls, each of them returns
+ * a new container type with the binding appended. Objects are created by the same `ObjectFactory` as in `Container`, but
+ * every dependency is resolved by overload resolution, so there is neither registry lookup nor virtual dispatch.
+ * Requesting a type that is not bound is a compile error.
+ *
+ * @tparam Bindings The list of `Bind` and `BindMulti` bindings.
+ */
+template <typename... Bindings>
+class StaticContainer
+{
+template <typename T, int N, typename C> friend struct CtorArg;
+
+public:
+  StaticContainer() = default;
+  StaticContainer(const StaticContainer&) = delete;
+  StaticContainer& operator=(const StaticContainer&) = delete;
+
+  /*
+   * @brief Returns a container with the class `T` bound to the interface `I` using the scope `S`.
+   *
+   * @tparam I The interface type under which the class `T` is bound.
+   * @tparam T The class type being bound, which must be derived from `I`.
+   * @tparam S The scope type of the binding, defaulting to `UniqueScope`.
+   * @tparam CallInit A boolean flag indicating whether to call the `init` method of `T` during instantiation.
+   * @return StaticContainer A new container type with the binding appended.
+   */
+  template <typename I, typename T, typename S = UniqueScope, bool CallInit = false>
+  EnableIf<IsBaseOf<I, T, S>, StaticContainer<Bindings..., Bind<I, T, S, CallInit>>> add() const;
+
+  /*
+   * @brief Returns a container with the class `T` bound using the scope `S`.
+   *
+   * @see add
+   */
+  template <typename T, typename S = UniqueScope, bool CallInit = false>
+  EnableIf<IsBaseOf<T, T, S>, StaticContainer<Bindings..., Bind<T, T, S, CallInit>>> add() const;
+
+  /*
+   * @brief Returns a container with the class `T` added to the classes resolved for `std::vector<I>`.
+   *
+   * @see add
+   */
+  template <typename I, typename T, typename S = UniqueScope, bool CallInit = false>
+  EnableIf<IsBaseOf<I, T, S>, StaticContainer<Bindings..., BindMulti<I, T, S, CallInit>>> addMulti() const;
+
+  /*
+   * @brief Returns a container with the class `T` added to the classes resolved for `std::vector<T>`.
+   *
+   * @see add
+   */
+  template <typename T, typename S = UniqueScope, bool CallInit = false>
+  EnableIf<IsBaseOf<T, T, S>, StaticContainer<Bindings..., BindMulti<T, T, S, CallInit>>> addMulti() const;
+
+  /*
+   * @brief Creates an instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type to be created.
+   * @return T An instance of the class `T`.
+   */
+  template <typename T>
+  T create() { return createImpl<T>(nullptr, nullptr); }
+
+  /*
+   * @brief Creates a pointer to and instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type for which a pointer will be created.
+   * @return T* A pointer to an instance of the class `T`.
+   */
+  template <typename T>
+  T* createPtr() { return create<T*>(); }
+
+  /*
+   * @brief Creates a shared pointer to and instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type for which a shared pointer will be created.
+   * @return std::shared_ptr<T> A shared pointer to an instance of the class `T`.
+   */
+  template <typename T>
+  std::shared_ptr<T> createShared() { return create<std::shared_ptr<T>>(); }
+
+  /*
+   * @brief Creates a unique pointer to and instance of the class `T` from the container, resolving dependencies.
+   *
+   * @tparam T The class type for which a unique pointer will be created.
+   * @return std::unique_ptr<T> A unique pointer to an instance of the class `T`.
+   */
+  template <typename T>
+  std::unique_ptr<T> createUnique() { return create<std::unique_ptr<T>>(); }
+
+  /*
+   * @brief Checks whether a single binding for the interface `I` is declared.
+   */
+  template <typename I>
+  static constexpr bool isBound() { return findBinding<RemoveCVRef<I>>() < sizeof...(Bindings); }
+
+private:
+  using BindingList = std::tuple<Bindings...>;
+
+  template <std::size_t K>
+  using Binding = std::tuple_element_t<K, BindingList>;
+
+  template <typename T>
+  T createImpl(Args* args, PlanStep* step);
+
+  template <typename T, std::size_t... K>
+  T createVector(std::index_sequence<K...>);
+
+  template <std::size_t K, typename T>
+  T createBound();
+
+  template <std::size_t K>
+  typename Binding<K>::Type* createInstance();
+
+  template <std::size_t K>
+  std::shared_ptr<typename Binding<K>::Type> createSharedInstance();
+
+  template <std::size_t K>
+  const std::shared_ptr<typename Binding<K>::Type>& getInstance();
+
+  template <typename I>
+  static constexpr std::size_t findBinding();
+
+  template <std::size_t K>
+  static constexpr std::size_t findInstance();
+
+private:
+  std::tuple<StaticSlot<Bindings>...> slots_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename I, typename T, typename S, bool CallInit>
+EnableIf<IsBaseOf<I, T, S>, StaticContainer<Bindings..., Bind<I, T, S, CallInit>>> StaticContainer<Bindings...>::add() const
+{
+  static_assert(!isBound<I>(), "Class already registered");
+  return {};
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename T, typename S, bool CallInit>
+EnableIf<IsBaseOf<T, T, S>, StaticContainer<Bindings..., Bind<T, T, S, CallInit>>> StaticContainer<Bindings...>::add() const
+{
+  return add<T, T, S, CallInit>();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename I, typename T, typename S, bool CallInit>
+EnableIf<IsBaseOf<I, T, S>, StaticContainer<Bindings..., BindMulti<I, T, S, CallInit>>>
+StaticContainer<Bindings...>::addMulti() const
+{
+  return {};
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename T, typename S, bool CallInit>
+EnableIf<IsBaseOf<T, T, S>, StaticContainer<Bindings..., BindMulti<T, T, S, CallInit>>>
+StaticContainer<Bindings...>::addMulti() const
+{
+  return addMulti<T, T, S, CallInit>();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename T>
+T StaticContainer<Bindings...>::createImpl(Args*, PlanStep*)
+{
+  if constexpr (IsVector<T>) {
+    return createVector<RemoveCV<T>>(std::index_sequence_for<Bindings...>{});
+  }
+  else {
+    constexpr std::size_t K = findBinding<typename StaticElement<T>::Type>();
+    static_assert(K < sizeof...(Bindings), "Class not registered");
+    return createBound<K, T>();
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename T, std::size_t... K>
+T StaticContainer<Bindings...>::createVector(std::index_sequence<K...>)
+{
+  using VectorElement = typename VectorTraits<T>::ElementType;
+  using Element = typename PointerTraits<VectorElement>::ElementType;
+  constexpr bool matches[] = { (Binding<K>::multi && std::is_same_v<typename Binding<K>::Interface, Element>)..., false };
+  static_assert((... || matches[K]), "Class not registered");
+  T result {};
+  result.reserve((0 + ... + (matches[K] ? 1 : 0)));
+  (..., [this, &result]() {
+    if constexpr (matches[K]) result.push_back(createBound<K, VectorElement>());
+  }());
+  return result;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <std::size_t K, typename T>
+T StaticContainer<Bindings...>::createBound()
+{
+  using B = Binding<K>;
+  using I = typename B::Interface;
+  if constexpr (IsSame<typename B::Scope, UniqueScope>) {
+    if constexpr (IsPurePtr<T>) {
+      I* ptr = createInstance<K>();
+      return ptr;
+    }
+    else if constexpr (IsSharedPtr<T>) {
+      return std::shared_ptr<I>(createSharedInstance<K>());
+    }
+    else if constexpr (IsIniquePtr<T>) {
+      return std::unique_ptr<I>(createInstance<K>());
+    }
+    else if constexpr (IsReference<T>) {
+      static_assert(AlwaysFalse<T>, "Creating a reference is not allowed under the Unique Scope");
+    }
+    else {
+      return ObjectFactory::create<RemoveCV<T>>(this, nullptr, B::callInit);
+    }
+  }
+  else {
+    if constexpr (IsPurePtr<T>) {
+      I* ptr = getInstance<K>().get();
+      return ptr;
+    }
+    else if constexpr (IsSharedPtr<T>) {
+      return std::shared_ptr<I>(getInstance<K>());
+    }
+    else if constexpr (IsIniquePtr<T>) {
+      return std::unique_ptr<I>(createInstance<K>());
+    }
+    else if constexpr (IsReference<T>) {
+      I& ref = *getInstance<K>();
+      return ref;
+    }
+    else {
+      static_assert(AlwaysFalse<T>, "Instantiation is not allowed by scope");
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <std::size_t K>
+typename StaticContainer<Bindings...>::template Binding<K>::Type* StaticContainer<Bindings...>::createInstance()
+{
+  using B = Binding<K>;
+  return ObjectFactory::createPtr<typename B::Type>(this, nullptr, B::callInit);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <std::size_t K>
+std::shared_ptr<typename StaticContainer<Bindings...>::template Binding<K>::Type>
+StaticContainer<Bindings...>::createSharedInstance()
+{
+  using B = Binding<K>;
+  return ObjectFactory::createShared<typename B::Type>(this, nullptr, B::callInit);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <std::size_t K>
+const std::shared_ptr<typename StaticContainer<Bindings...>::template Binding<K>::Type>&
+StaticContainer<Bindings...>::getInstance()
+{
+  return std::get<findInstance<K>()>(slots_).get([this]() {
+    return createSharedInstance<K>();
+  });
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <typename I>
+constexpr std::size_t StaticContainer<Bindings...>::findBinding()
+{
+  constexpr bool matches[] = { (!Bindings::multi && std::is_same_v<typename Bindings::Interface, I>)..., false };
+  std::size_t k = 0;
+  while (k < sizeof...(Bindings) && !matches[k]) ++k;
+  return k;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename... Bindings>
+template <std::size_t K>
+constexpr std::size_t StaticContainer<Bindings...>::findInstance()
+{
+  if constexpr (IsSame<typename Binding<K>::Scope, SharedImlpScope>) {
+    constexpr bool matches[] = {
+      (IsSame<typename Bindings::Scope, SharedImlpScope> && std::is_same_v<typename Bindings::Type, typename Binding<K>::Type>)...
+    };
+    std::size_t k = 0;
+    while (!matches[k]) ++k;
+    return k;
+  }
+  else {
+    return K;
+  }
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_STATIC_CONTAINER_H
\ No newline at end of file
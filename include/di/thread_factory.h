@@ -0,0 +1,105 @@
+#ifndef YAGA_DI_THREAD_FACTORY
+#define YAGA_DI_THREAD_FACTORY
+
+#include <memory>
+
+#include "di/factory.h"
+#include "di/object_factory.h"
+#include "di/thread_instance.h"
+
+namespace yaga {
+namespace di {
+
+template <typename I, typename T>
+class ThreadFactory : public Factory
+{
+public:
+  explicit ThreadFactory(bool callInit = false);
+
+protected:
+  void* createPure(Container* container, Args* args) override;
+
+  std::shared_ptr<void> createShared(Container* container, Args* args) override;
+
+  void* createUnique(Container* container, Args* args) override;
+
+  void* createReference(Container* container, Args* args) override;
+
+  bool allowInstanceCreation() override { return false; }
+
+  std::shared_ptr<T> getInstance(Container* container, Args* args);
+
+  virtual T* createInstance(Container* container, Args* args);
+
+  virtual std::shared_ptr<T> createSharedInstance(Container* container, Args* args);
+
+protected:
+  ThreadInstance<T> instance_;
+  Plan<T> plan_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+ThreadFactory<I, T>::ThreadFactory(bool callInit) :
+  Factory(callInit)
+{
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+T* ThreadFactory<I, T>::createInstance(Container* container, Args* args)
+{
+  return ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<T> ThreadFactory<I, T>::createSharedInstance(Container* container, Args* args)
+{
+  return ObjectFactory::createShared<T>(container, args, callInit_, &plan_, resource(container));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<T> ThreadFactory<I, T>::getInstance(Container* container, Args* args)
+{
+  return instance_.get([this, container, args]() {
+    return createSharedInstance(container, args);
+  });
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+void* ThreadFactory<I, T>::createPure(Container* container, Args* args)
+{
+  I* ptr = getInstance(container, args).get();
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<void> ThreadFactory<I, T>::createShared(Container* container, Args* args)
+{
+  std::shared_ptr<I> ptr = getInstance(container, args);
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+void* ThreadFactory<I, T>::createUnique(Container* container, Args* args)
+{
+  I* ptr = createInstance(container, args);
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+void* ThreadFactory<I, T>::createReference(Container* container, Args* args)
+{
+  return createPure(container, args);
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_THREAD_FACTORY
\ No newline at end of file
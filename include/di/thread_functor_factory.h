@@ -0,0 +1,50 @@
+#ifndef YAGA_DI_THREAD_FUNCTOR_FACTORY
+#define YAGA_DI_THREAD_FUNCTOR_FACTORY
+
+#include <memory>
+
+#include "di/thread_factory.h"
+
+namespace yaga {
+namespace di {
+
+template <typename I, typename T, typename F>
+class ThreadFunctorFactory : public ThreadFactory<I, T>
+{
+public:
+  explicit ThreadFunctorFactory(F functor);
+
+protected:
+  T* createInstance(Container* container, Args* args) override;
+
+  std::shared_ptr<T> createSharedInstance(Container* container, Args* args) override;
+
+private:
+  F functor_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+ThreadFunctorFactory<I, T, F>::ThreadFunctorFactory(F functor) :
+  functor_(functor)
+{
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+T* ThreadFunctorFactory<I, T, F>::createInstance(Container* container, Args*)
+{
+  return FunctorInvoker::invoke<F>(functor_, container);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+std::shared_ptr<T> ThreadFunctorFactory<I, T, F>::createSharedInstance(Container* container, Args* args)
+{
+  return std::shared_ptr<T>(this->createInstance(container, args));
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_THREAD_FUNCTOR_FACTORY
\ No newline at end of file
@@ -0,0 +1,194 @@
+#ifndef YAGA_DI_THREAD_INSTANCE
+#define YAGA_DI_THREAD_INSTANCE
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "di/init_graph.h"
+#include "di/request_arena.h"
+#include "di/resolution_context.h"
+#include "di/type_id.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Per-thread lookup of the ThreadScope instances.
+ *
+ * Every `ThreadInstance` owns a slot index, released for reuse when it is destroyed, and a unique owner id. Each thread
+ * keeps a thread-local table indexed by the slot pointing into the instances of the owner, an entry left by a former
+ * owner of the slot is recognized by its id. The instances themselves belong to their `ThreadInstance`, so they are
+ * destroyed together with the container, the table only drops those of live owners when the thread exits.
+ */
+class ThreadSlots
+{
+public:
+  using Instances = std::list<std::shared_ptr<void>>;
+
+  /*
+   * @brief Instances of a single `ThreadInstance` created by all the threads.
+   */
+  struct Owner
+  {
+    std::mutex mutex;
+    Instances instances;
+  };
+
+  struct Entry
+  {
+    std::size_t id = 0;
+    std::weak_ptr<Owner> owner;
+    Instances::iterator instance;
+  };
+
+  static inline std::size_t allocate();
+
+  static inline void release(std::size_t slot);
+
+  static std::size_t identify()
+  {
+    static std::atomic<std::size_t> next { 1 };
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static Entry& get(std::size_t slot)
+  {
+    thread_local Table table;
+    if (slot >= table.entries.size()) table.entries.resize(slot + 1);
+    return table.entries[slot];
+  }
+
+  /*
+   * @brief Removes the instance of the entry `entry` from its owner, if the owner is still alive.
+   */
+  static inline void drop(Entry& entry);
+
+private:
+  struct Table
+  {
+    std::deque<Entry> entries;
+
+    ~Table()
+    {
+      for (auto& entry : entries) {
+        drop(entry);
+      }
+    }
+  };
+
+  struct Freed
+  {
+    std::mutex mutex;
+    std::vector<std::size_t> slots;
+    std::size_t next = 0;
+  };
+
+  static Freed& freed()
+  {
+    static Freed freed;
+    return freed;
+  }
+};
+
+/*
+ * @brief Holds a lazily created instance per thread.
+ *
+ * The instance of the calling thread is looked up in thread-local storage, so no lock is taken once it exists. An
+ * instance whose initialization fails is dropped once the resolution that created it is over, so that it is created
+ * again.
+ */
+template <typename T>
+class ThreadInstance
+{
+public:
+  ThreadInstance() : slot_(ThreadSlots::allocate()), id_(ThreadSlots::identify()) {}
+  ThreadInstance(const ThreadInstance&) = delete;
+  ThreadInstance& operator=(const ThreadInstance&) = delete;
+  ~ThreadInstance() { ThreadSlots::release(slot_); }
+
+  template <typename F>
+  std::shared_ptr<T> get(F create);
+
+private:
+  std::size_t slot_;
+  std::size_t id_;
+  std::shared_ptr<ThreadSlots::Owner> owner_ = std::make_shared<ThreadSlots::Owner>();
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+std::size_t ThreadSlots::allocate()
+{
+  auto& freed = ThreadSlots::freed();
+  std::lock_guard<std::mutex> lock(freed.mutex);
+  if (freed.slots.empty()) return freed.next++;
+  auto slot = freed.slots.back();
+  freed.slots.pop_back();
+  return slot;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void ThreadSlots::release(std::size_t slot)
+{
+  auto& freed = ThreadSlots::freed();
+  std::lock_guard<std::mutex> lock(freed.mutex);
+  freed.slots.push_back(slot);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void ThreadSlots::drop(Entry& entry)
+{
+  std::shared_ptr<void> instance;
+  if (auto owner = entry.owner.lock()) {
+    std::lock_guard<std::mutex> lock(owner->mutex);
+    instance = std::move(*entry.instance);
+    owner->instances.erase(entry.instance);
+  }
+  entry = Entry();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+template <typename F>
+std::shared_ptr<T> ThreadInstance<T>::get(F create)
+{
+  auto& entry = ThreadSlots::get(slot_);
+  if (entry.id != id_) {
+    if (ResolutionContext::constructing(this)) {
+      throw std::runtime_error(std::string("Circular dependency on class ") + typeName<T>());
+    }
+    ResolutionContext::Guard guard(this);
+    RequestArena::Suspension suspension;
+    InitGraph::Frame frame;
+    auto settlement = ResolutionContext::current();
+    auto first = settlement ? settlement->size() : 0;
+    std::shared_ptr<T> instance = create();
+    if (auto node = frame.finish()) InitGraph::current()->bind(this, node);
+    {
+      std::lock_guard<std::mutex> lock(owner_->mutex);
+      entry.instance = owner_->instances.insert(owner_->instances.end(), instance);
+    }
+    entry.id = id_;
+    entry.owner = owner_;
+    if (settlement && settlement->size() > first) {
+      settlement->onSettled([this](bool succeeded) {
+        auto& entry = ThreadSlots::get(slot_);
+        if (!succeeded && entry.id == id_) ThreadSlots::drop(entry);
+      });
+    }
+    return instance;
+  }
+  if (auto graph = InitGraph::current()) graph->reuse(this);
+  return std::static_pointer_cast<T>(*entry.instance);
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_THREAD_INSTANCE
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef YAGA_DI_TYPE_ID
+#define YAGA_DI_TYPE_ID
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "di/type_traits.h"
+
+namespace yaga {
+namespace di {
+
+/*
+ * @brief Dense integer identifier of a type.
+ *
+ * Identifiers are assigned once per process on first use, starting from zero, so they can be used as indices into flat
+ * tables. Unlike `std::type_index` they neither require RTTI nor hash the mangled type name.
+ */
+using TypeId = std::size_t;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class TypeIdGenerator
+{
+template <typename T> friend struct TypeIdStorage;
+
+public:
+  inline static TypeId count();
+
+private:
+  inline static std::atomic<TypeId>& counter();
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+struct TypeIdStorage
+{
+  static TypeId get()
+  {
+    static const TypeId id = TypeIdGenerator::counter().fetch_add(1, std::memory_order_relaxed);
+    return id;
+  }
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+std::atomic<TypeId>& TypeIdGenerator::counter()
+{
+  static std::atomic<TypeId> counter { 0 };
+  return counter;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+TypeId TypeIdGenerator::count()
+{
+  return counter().load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+TypeId typeId()
+{
+  return TypeIdStorage<RemoveCVRef<T>>::get();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+std::string typeName()
+{
+#if defined(_MSC_VER)
+  std::string_view name = __FUNCSIG__;
+  auto begin = name.find("typeName<") + 9;
+  auto end = name.rfind(">(void)");
+#else
+  std::string_view name = __PRETTY_FUNCTION__;
+  auto begin = name.find("T = ") + 4;
+  auto end = name.find(';', begin);
+  if (end == std::string_view::npos) end = name.rfind(']');
+#endif
+  return std::string(name.substr(begin, end - begin));
+}
+
+} // !namespace di
+} // !namespace yaga
+
+#endif // !YAGA_DI_TYPE_ID
\ No newline at end of file
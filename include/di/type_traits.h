@@ -59,8 +59,8 @@ constexpr bool IsIniquePtr = UniquePtrTraits<T>::value;
 template <typename T>
 struct VectorTraits : std::false_type {};
 
-template <typename T>
-struct VectorTraits<std::vector<T>> : std::true_type
+template <typename T, typename A>
+struct VectorTraits<std::vector<T, A>> : std::true_type
 {
   using ElementType = T;
 };
@@ -68,6 +68,16 @@ struct VectorTraits<std::vector<T>> : std::true_type
 template <typename T>
 constexpr bool IsVector = VectorTraits<RemoveCV<T>>::value;
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+struct CopyableTraits : std::is_copy_constructible<T> {};
+
+template <typename T, typename A>
+struct CopyableTraits<std::vector<T, A>> : CopyableTraits<T> {};
+
+template <typename T>
+constexpr bool IsCopyable = CopyableTraits<RemoveCV<T>>::value;
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 struct PointerTraits
@@ -98,6 +108,94 @@ struct IsFunctionT<std::function<Ret(Args...)>> : std::true_type {};
 template<typename T>
 inline constexpr bool IsFunction = IsFunctionT<T>::value;
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+class Provider;
+
+template <typename T, bool = IsPointer<T> || IsReference<T>>
+struct ProviderElement
+{
+  using Type = typename PointerTraits<T>::ElementType;
+};
+
+template <typename T>
+struct ProviderElement<T, false>
+{
+  using Type = RemoveCVRef<T>;
+};
+
+template <typename T>
+struct ProviderTraits : std::false_type {};
+
+template <typename T>
+struct ProviderTraits<Provider<T>> : std::true_type
+{
+  using ResultType = T;
+  using ElementType = typename ProviderElement<T>::Type;
+};
+
+template <typename T>
+constexpr bool IsProvider = ProviderTraits<RemoveCV<T>>::value;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+class Lazy;
+
+template <typename T>
+struct LazyTraits : std::false_type {};
+
+template <typename T>
+struct LazyTraits<Lazy<T>> : std::true_type
+{
+  using ResultType = T;
+};
+
+template <typename T>
+constexpr bool IsLazy = LazyTraits<RemoveCV<T>>::value;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+class Ref;
+
+template <typename T>
+struct RefTraits : std::false_type {};
+
+template <typename T>
+struct RefTraits<Ref<T>> : std::true_type
+{
+  using ElementType = T;
+};
+
+template <typename T>
+constexpr bool IsRef = RefTraits<RemoveCV<T>>::value;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+class MultiView;
+
+template <typename T>
+struct MultiViewTraits : std::false_type {};
+
+template <typename T>
+struct MultiViewTraits<MultiView<T>> : std::true_type
+{
+  using ElementType = T;
+};
+
+template <typename T>
+constexpr bool IsMultiView = MultiViewTraits<RemoveCV<T>>::value;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+constexpr bool IsSpecial =
+  IsPointer<RemoveCV<T>> ||
+  IsFunction<RemoveCV<T>> ||
+  IsVector<T> ||
+  IsProvider<T> ||
+  IsLazy<T> ||
+  IsRef<T> ||
+  IsMultiView<T>;
+
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 struct FunctionTraits;
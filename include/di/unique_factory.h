@@ -5,6 +5,7 @@
 
 #include "di/factory.h"
 #include "di/object_factory.h"
+#include "di/request_arena.h"
 
 namespace yaga {
 namespace di {
@@ -27,6 +28,13 @@ protected:
   bool allowInstanceCreation() override { return true; }
 
   virtual T* createInstance(Container* container, Args* args);
+
+  virtual std::shared_ptr<T> createSharedInstance(Container* container, Args* args);
+
+  virtual T* createArenaInstance(Container* container, Args* args, RequestArena* arena);
+
+protected:
+  Plan<T> plan_;
 };
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -40,13 +48,33 @@ UniqueFactory<I, T>::UniqueFactory(bool callInit) :
 template <typename I, typename T>
 T* UniqueFactory<I, T>::createInstance(Container* container, Args* args)
 {
-  return ObjectFactory::createPtr<T>(container, args, callInit_);
+  return ObjectFactory::createPtr<T>(container, args, callInit_, &plan_);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+std::shared_ptr<T> UniqueFactory<I, T>::createSharedInstance(Container* container, Args* args)
+{
+  return ObjectFactory::createShared<T>(container, args, callInit_, &plan_, resource(container));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T>
+T* UniqueFactory<I, T>::createArenaInstance(Container* container, Args* args, RequestArena* arena)
+{
+  return arena->create<T>([this, container, args](void* place) {
+    return ObjectFactory::createAt<T>(place, container, args, callInit_, &plan_);
+  });
 }
 
 // -----------------------------------------------------------------------------------------------------------------------------
 template <typename I, typename T>
 void* UniqueFactory<I, T>::createPure(Container* container, Args* args)
 {
+  if (auto arena = RequestArena::current()) {
+    I* ptr = createArenaInstance(container, args, arena);
+    return ptr;
+  }
   I* ptr = createInstance(container, args);
   return ptr;
 }
@@ -55,7 +83,7 @@ void* UniqueFactory<I, T>::createPure(Container* container, Args* args)
 template <typename I, typename T>
 std::shared_ptr<void> UniqueFactory<I, T>::createShared(Container* container, Args* args)
 {
-  std::shared_ptr<I> ptr = std::shared_ptr<I>(createInstance(container, args));
+  std::shared_ptr<I> ptr = createSharedInstance(container, args);
   return ptr;
 }
 
@@ -71,7 +99,7 @@ void* UniqueFactory<I, T>::createUnique(Container* container, Args* args)
 template <typename I, typename T>
 void* UniqueFactory<I, T>::createReference(Container*, Args*)
 {
-  throw std::runtime_error(std::string("Creating a reference to ") + typeid(T).name() + " is not allowed under the Unique Scope");
+  throw std::runtime_error(std::string("Creating a reference to ") + typeName<T>() + " is not allowed under the Unique Scope");
 }
 
 } // !namespace di
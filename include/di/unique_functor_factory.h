@@ -17,6 +17,10 @@ public:
 protected:  
   T* createInstance(Container* container, Args* args) override;
 
+  std::shared_ptr<T> createSharedInstance(Container* container, Args* args) override;
+
+  T* createArenaInstance(Container* container, Args* args, RequestArena* arena) override;
+
 private:
   F functor_;
 };
@@ -35,6 +39,20 @@ T* UniqueFunctorFactory<I, T, F>::createInstance(Container* container, Args*)
   return FunctorInvoker::invoke<F>(functor_, container);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+std::shared_ptr<T> UniqueFunctorFactory<I, T, F>::createSharedInstance(Container* container, Args* args)
+{
+  return std::shared_ptr<T>(this->createInstance(container, args));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <typename I, typename T, typename F>
+T* UniqueFunctorFactory<I, T, F>::createArenaInstance(Container* container, Args* args, RequestArena* arena)
+{
+  return arena->adopt(this->createInstance(container, args));
+}
+
 } // !namespace di
 } // !namespace yaga
 
@@ -0,0 +1,39 @@
+# Compiles SOURCE to assembly and checks that the functions viaStaticContainer and handWritten consist of the same
+# instructions, local labels aside.
+execute_process(
+  COMMAND ${COMPILER} -std=c++20 -O2 -S -I${INCLUDE_DIR} ${SOURCE} -o ${OUTPUT}
+  RESULT_VARIABLE result
+)
+if(result)
+  message(FATAL_ERROR "Compiling ${SOURCE} failed")
+endif()
+
+file(STRINGS ${OUTPUT} lines)
+
+function(extract_instructions name out)
+  set(inside FALSE)
+  set(instructions "")
+  foreach(line IN LISTS lines)
+    if(line MATCHES "^_?${name}:")
+      set(inside TRUE)
+    elseif(inside AND line MATCHES "\\.cfi_endproc")
+      break()
+    elseif(inside AND line MATCHES "^\t[a-z]")
+      string(REGEX REPLACE "\\.?L[A-Za-z_]*[0-9]+" "" line "${line}")
+      list(APPEND instructions "${line}")
+    endif()
+  endforeach()
+  set(${out} "${instructions}" PARENT_SCOPE)
+endfunction()
+
+extract_instructions(viaStaticContainer container)
+extract_instructions(handWritten expected)
+if(NOT container)
+  message(FATAL_ERROR "viaStaticContainer not found in ${OUTPUT}")
+endif()
+if(NOT container STREQUAL expected)
+  list(LENGTH container containerCount)
+  list(LENGTH expected expectedCount)
+  message(FATAL_ERROR
+    "StaticContainer takes ${containerCount} instructions instead of ${expectedCount}:\n${container}\n${expected}")
+endif()
@@ -0,0 +1,25 @@
+#include "di/di.h"
+
+/*
+ * Compiled to assembly by the di_codegen test, which checks that creating an object from a StaticContainer takes
+ * the same instructions as creating it by hand.
+ */
+struct CodegenLeaf {};
+
+struct CodegenRoot
+{
+  explicit CodegenRoot(CodegenLeaf* leaf) : leaf(leaf) {}
+  CodegenLeaf* leaf;
+};
+
+using CodegenContainer = yaga::di::StaticContainer<yaga::di::Bind<CodegenLeaf>, yaga::di::Bind<CodegenRoot>>;
+
+extern "C" CodegenRoot* viaStaticContainer(CodegenContainer& container)
+{
+  return container.create<CodegenRoot*>();
+}
+
+extern "C" CodegenRoot* handWritten()
+{
+  return new CodegenRoot(new CodegenLeaf);
+}
@@ -1,10 +1,21 @@
 #include "di/di.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <memory_resource>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <boost/test/unit_test.hpp>
 
 using namespace yaga;
 
+// Counted by the replaceable global operator new defined in main.cpp.
+extern thread_local std::size_t allocationCount;
+
 BOOST_AUTO_TEST_SUITE(DiTest)
 
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -1368,4 +1379,1425 @@ BOOST_AUTO_TEST_CASE(FactoryChain)
   BOOST_TEST(inst->dependency() != nullptr);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(TypeIds)
+{
+  BOOST_TEST(di::typeId<IDependency>() == di::typeId<IDependency>());
+  BOOST_TEST(di::typeId<IDependency>() == di::typeId<const IDependency&>());
+  BOOST_TEST(di::typeId<IDependency>() != di::typeId<IDependency*>());
+  BOOST_TEST(di::typeId<Dependency1>() != di::typeId<Dependency2>());
+  BOOST_TEST(di::typeId<Dependency1>() < di::TypeIdGenerator::count());
+  BOOST_TEST(di::typeName<Dependency1>().find("Dependency1") != std::string::npos);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class CountedDependency final : public IDependency
+{
+public:
+  static std::atomic<int> ctorCalls;
+
+public:
+  CountedDependency() { ++ctorCalls; }
+  std::string& str() override { return str_; }
+
+private:
+  std::string str_;
+};
+
+std::atomic<int> CountedDependency::ctorCalls = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FreezeCreate)
+{
+  di::Container container;
+  container.add<IDependency, Dependency1, di::SharedScope>();
+  container.add<SharedPtrDependant>();
+  auto resolved = container.freeze();
+  BOOST_TEST(container.frozen());
+  auto inst1 = resolved.createShared<SharedPtrDependant>();
+  auto inst2 = resolved.createShared<SharedPtrDependant>();
+  BOOST_TEST(inst1 != inst2);
+  BOOST_TEST(inst1->dependency() == inst2->dependency());
+  BOOST_TEST(container.createShared<IDependency>() == inst1->dependency());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FreezeRejectsRegistration)
+{
+  di::Container container;
+  container.add<IDependency, Dependency1>();
+  container.freeze();
+  try {
+    container.add<Dependency2>();
+    BOOST_TEST(false);
+  }
+  catch (...) {}
+  try {
+    container.addMulti<IDependency, Dependency2>();
+    BOOST_TEST(false);
+  }
+  catch (...) {}
+  try {
+    container.addFactory<di::UniqueScope>([]() { return new Dependency3(); });
+    BOOST_TEST(false);
+  }
+  catch (...) {}
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FreezeSharedConcurrent)
+{
+  CountedDependency::ctorCalls = 0;
+  di::Container container;
+  container.add<IDependency, CountedDependency, di::SharedScope>();
+  auto resolved = container.freeze();
+  std::vector<std::thread> threads;
+  std::vector<IDependency*> instances(8);
+  for (size_t i = 0; i < instances.size(); ++i) {
+    threads.emplace_back([&resolved, &instances, i]() { instances[i] = resolved.createPtr<IDependency>(); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_TEST(CountedDependency::ctorCalls == 1);
+  for (auto instance : instances) {
+    BOOST_TEST(instance == instances[0]);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct FourDependant
+{
+  FourDependant(
+    IDependency* d1,
+    std::shared_ptr<IDependency2> d2,
+    std::unique_ptr<FactoryArg1> d3,
+    FactoryArg2 d4) :
+    d1(d1), d2(d2), d3(std::move(d3)), d4(d4) {}
+  std::unique_ptr<IDependency> d1;
+  std::shared_ptr<IDependency2> d2;
+  std::unique_ptr<FactoryArg1> d3;
+  FactoryArg2 d4;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ResolutionPlan)
+{
+  di::Container container;
+  container.add<IDependency, Dependency1>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.add<FactoryArg1>();
+  container.add<FactoryArg2>();
+  container.add<FourDependant>();
+  auto inst1 = container.createUnique<FourDependant>();
+  auto inst2 = container.createUnique<FourDependant>();
+  auto inst3 = container.createUnique<FourDependant>();
+  BOOST_TEST(inst1->d1 != nullptr);
+  BOOST_TEST(inst1->d1 != inst2->d1);
+  BOOST_TEST(inst2->d1 != inst3->d1);
+  BOOST_TEST(inst1->d2 == inst2->d2);
+  BOOST_TEST(inst2->d2 == inst3->d2);
+  BOOST_TEST(inst1->d3 != inst2->d3);
+  BOOST_TEST(inst3->d3 != nullptr);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ResolutionPlanArgs)
+{
+  di::Container container;
+  container.add<FactoryResultPure>();
+  container.add<FactoryArg1, di::SharedScope>();
+  container.add<FactoryArg2, di::SharedScope>();
+  container.add<FactoryArg3, di::SharedScope>();
+  auto result1 = container.createUnique<FactoryResultPure>();
+  auto result2 = container.createUnique<FactoryResultPure>();
+  BOOST_TEST(result1->arg3 == result2->arg3);
+  FactoryArg3 arg3 { 3 };
+  auto factory = container.create<std::function<FactoryResultPure*(FactoryArg3*)>>();
+  std::unique_ptr<FactoryResultPure> result3(factory(&arg3));
+  BOOST_TEST(result3->arg1 == result1->arg1);
+  BOOST_TEST(result3->arg3 == &arg3);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(StaticContainerScopes)
+{
+  auto container = di::StaticContainer<>()
+    .add<IDependency, Dependency1, di::SharedScope>()
+    .add<IDependency2, DoubleDependency>()
+    .add<FactoryArg1>()
+    .add<FactoryArg2>()
+    .add<FourDependant>();
+  static_assert(decltype(container)::isBound<FourDependant>());
+  static_assert(!decltype(container)::isBound<Dependency2>());
+  auto inst1 = container.createUnique<FourDependant>();
+  auto inst2 = container.createShared<FourDependant>();
+  BOOST_TEST(inst1->d2 != nullptr);
+  BOOST_TEST(inst1->d2 != inst2->d2);
+  BOOST_TEST(inst1->d3 != inst2->d3);
+  BOOST_TEST(container.createPtr<IDependency>() == container.createPtr<IDependency>());
+  container.create<IDependency&>().str() = "instance1";
+  BOOST_TEST(container.createShared<IDependency>()->str() == "instance1");
+  inst1->d1.release();
+  inst2->d1.release();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(StaticContainerSharedImpl)
+{
+  di::StaticContainer<
+    di::Bind<IDependency, DoubleDependency, di::SharedImlpScope>,
+    di::Bind<IDependency2, DoubleDependency, di::SharedImlpScope>> container;
+  auto dd1 = std::dynamic_pointer_cast<DoubleDependency>(container.createShared<IDependency>());
+  auto dd2 = std::dynamic_pointer_cast<DoubleDependency>(container.createShared<IDependency2>());
+  BOOST_TEST(dd1 != nullptr);
+  BOOST_TEST(dd1 == dd2);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(StaticContainerVector)
+{
+  auto container = di::StaticContainer<>()
+    .addMulti<IDependency, Dependency1, di::SharedScope>()
+    .addMulti<IDependency, Dependency2, di::SharedScope>()
+    .add<IDependency, Dependency3, di::SharedScope>()
+    .add<VectorDependant>();
+  auto vector = container.create<std::vector<std::shared_ptr<IDependency>>>();
+  BOOST_TEST(vector.size() == 2);
+  vector[0]->str() = "instance1";
+  vector[1]->str() = "instance2";
+  container.createPtr<IDependency>()->str() = "instance3";
+  auto d = container.createShared<VectorDependant>();
+  BOOST_TEST(d->dependencies()[0]->str() == "instance1");
+  BOOST_TEST(d->dependencies()[1]->str() == "instance2");
+  BOOST_TEST(d->str() == "instance3");
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class SlowDependency final : public IDependency
+{
+public:
+  static std::atomic<bool> started;
+  static std::atomic<bool> released;
+
+public:
+  SlowDependency()
+  {
+    started = true;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!released && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    releasedInTime_ = released;
+  }
+  std::string& str() override { return str_; }
+  bool releasedInTime() const { return releasedInTime_; }
+
+private:
+  std::string str_;
+  bool releasedInTime_;
+};
+
+std::atomic<bool> SlowDependency::started { false };
+std::atomic<bool> SlowDependency::released { false };
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SlowSharedDoesNotBlock)
+{
+  di::Container container;
+  container.add<IDependency, SlowDependency, di::SharedScope>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  std::thread thread([&container]() { container.createPtr<IDependency>(); });
+  while (!SlowDependency::started) {
+    std::this_thread::yield();
+  }
+  container.createPtr<IDependency2>()->integer() = 1;
+  SlowDependency::released = true;
+  thread.join();
+  auto slow = dynamic_cast<SlowDependency*>(container.createPtr<IDependency>());
+  BOOST_TEST(slow->releasedInTime());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RegistrySegments)
+{
+  di::Registry<int> registry;
+  std::vector<int> values(1000);
+  for (size_t i = 0; i < values.size(); i += 3) {
+    registry.set(i, &values[i]);
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    BOOST_TEST(registry.find(i) == (i % 3 ? nullptr : &values[i]));
+  }
+  BOOST_TEST(registry.find(1000000) == nullptr);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class NestedFactoryDependency final : public IDependency
+{
+public:
+  explicit NestedFactoryDependency(std::function<IDependency2*()> factory) : factory_(factory) {}
+  std::string& str() override { return str_; }
+  void init() { nested_.reset(factory_()); }
+  IDependency2* nested() { return nested_.get(); }
+
+private:
+  std::string str_;
+  std::function<IDependency2*()> factory_;
+  std::unique_ptr<IDependency2> nested_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class CircularDependency final : public IDependency
+{
+public:
+  explicit CircularDependency(std::function<IDependency*()> factory) { factory(); }
+  std::string& str() override { return str_; }
+
+private:
+  std::string str_;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(NestedResolution)
+{
+  di::Container container;
+  container.add<IDependency, NestedFactoryDependency, di::SharedScope, true>();
+  container.add<IDependency2, DoubleDependency>();
+  auto d = dynamic_cast<NestedFactoryDependency*>(container.createPtr<IDependency>());
+  BOOST_TEST(d->nested() != nullptr);
+  BOOST_TEST(di::ResolutionContext::depth() == 0);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CircularResolution)
+{
+  di::Container container;
+  container.add<IDependency, CircularDependency, di::SharedScope>();
+  try {
+    container.createPtr<IDependency>();
+    BOOST_TEST(false);
+  }
+  catch (const std::runtime_error& ex) {
+    BOOST_TEST(std::string(ex.what()).find("Circular dependency") == 0);
+  }
+  BOOST_TEST(di::ResolutionContext::depth() == 0);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(Warmup)
+{
+  CountedDependency::ctorCalls = 0;
+  di::Container container;
+  container.add<SharedPtrDependant, di::SharedScope>();
+  container.add<IDependency, CountedDependency, di::SharedScope>();
+  container.add<IDependency2, DoubleDependency, di::SharedImlpScope>();
+  container.add<InitDependency, di::SharedScope, true>();
+  container.add<FactoryArg1>();
+  container.addMulti<IDependency, Dependency1, di::SharedScope>();
+  auto report = container.warmup(4);
+  BOOST_TEST(report.instances == 5);
+  BOOST_TEST(report.wallTime.count() > 0);
+  BOOST_TEST(CountedDependency::ctorCalls == 1);
+  BOOST_TEST(container.createPtr<InitDependency>()->counter() == 1);
+  BOOST_TEST(container.createPtr<SharedPtrDependant>()->dependency() == container.createShared<IDependency>());
+  BOOST_TEST(CountedDependency::ctorCalls == 1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(WarmupSharedImplOnce)
+{
+  di::Container container;
+  container.add<IDependency, DoubleDependency, di::SharedImlpScope>();
+  container.add<IDependency2, DoubleDependency, di::SharedImlpScope>();
+  auto report = container.warmup(2);
+  BOOST_TEST(report.instances == 1);
+  BOOST_TEST(dynamic_cast<DoubleDependency*>(container.createPtr<IDependency>()) ==
+    dynamic_cast<DoubleDependency*>(container.createPtr<IDependency2>()));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ThreadScope)
+{
+  Dependency1::dtorCalls = 0;
+  di::Container container;
+  container.add<IDependency, Dependency1, di::ThreadScope>();
+  container.add<SharedPtrDependant, di::ThreadScope>();
+  auto main1 = container.createPtr<IDependency>();
+  auto main2 = container.createPtr<IDependency>();
+  BOOST_TEST(main1 == main2);
+  IDependency* other1 = nullptr;
+  IDependency* other2 = nullptr;
+  std::thread thread([&container, &other1, &other2]() {
+    other1 = container.createPtr<IDependency>();
+    other2 = container.createPtr<SharedPtrDependant>()->dependency().get();
+  });
+  thread.join();
+  BOOST_TEST(other1 == other2);
+  BOOST_TEST(other1 != main1);
+  BOOST_TEST(Dependency1::dtorCalls == 1);
+  BOOST_TEST(container.createPtr<SharedPtrDependant>()->dependency().get() == main1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ThreadScopeOwnedByContainer)
+{
+  auto slots = std::minmax({ di::ThreadSlots::allocate(), di::ThreadSlots::allocate() });
+  di::ThreadSlots::release(slots.first);
+  di::ThreadSlots::release(slots.second);
+  Dependency1::dtorCalls = 0;
+  {
+    di::Container container;
+    container.add<IDependency, Dependency1, di::ThreadScope>();
+    container.add<SharedPtrDependant, di::ThreadScope>();
+    BOOST_TEST(container.createPtr<SharedPtrDependant>()->dependency().get() == container.createPtr<IDependency>());
+  }
+  BOOST_TEST(Dependency1::dtorCalls == 1);
+  auto reused = std::minmax({ di::ThreadSlots::allocate(), di::ThreadSlots::allocate() });
+  BOOST_TEST((reused == slots));
+  di::ThreadSlots::release(reused.first);
+  di::ThreadSlots::release(reused.second);
+  di::Container container;
+  container.add<IDependency, Dependency1, di::ThreadScope>();
+  BOOST_TEST(container.createPtr<IDependency>() != nullptr);
+  BOOST_TEST(Dependency1::dtorCalls == 1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct Rendezvous
+{
+  static std::atomic<int> arrived;
+
+  static bool meet(int count)
+  {
+    ++arrived;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (arrived < count && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    return arrived >= count;
+  }
+};
+
+std::atomic<int> Rendezvous::arrived { 0 };
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <int N>
+class AsyncInitDependency
+{
+public:
+  std::future<void> initAsync()
+  {
+    return std::async(std::launch::async, [this]() {
+      overlapped_ = Rendezvous::meet(2);
+      ready_ = true;
+    });
+  }
+  bool ready() const { return ready_; }
+  bool overlapped() const { return overlapped_; }
+
+private:
+  std::atomic<bool> ready_ { false };
+  std::atomic<bool> overlapped_ { false };
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct AsyncInitDependant
+{
+  AsyncInitDependant(AsyncInitDependency<1>* d1, AsyncInitDependency<2>* d2) : d1(d1), d2(d2) {}
+  AsyncInitDependency<1>* d1;
+  AsyncInitDependency<2>* d2;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateAsync)
+{
+  di::Container container;
+  container.add<AsyncInitDependency<1>, di::SharedScope, true>();
+  container.add<AsyncInitDependency<2>, di::SharedScope, true>();
+  container.add<AsyncInitDependant>();
+  Rendezvous::arrived = 0;
+  auto future = container.createAsync<std::unique_ptr<AsyncInitDependant>>([](std::function<void()> task) { task(); });
+  auto d = future.get();
+  BOOST_TEST(d->d1->ready());
+  BOOST_TEST(d->d2->ready());
+  BOOST_TEST(d->d1->overlapped());
+  BOOST_TEST(d->d2->overlapped());
+  BOOST_TEST(container.createAsync<AsyncInitDependency<1>*>().get() == d->d1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class GatedInit
+{
+public:
+  static std::atomic<int> ctorCalls;
+  static std::atomic<int> failures;
+  static std::promise<void>* gate;
+
+public:
+  GatedInit() { ++ctorCalls; }
+
+  std::future<void> initAsync()
+  {
+    return std::async(std::launch::async, [this]() {
+      if (gate) gate->get_future().wait();
+      if (failures > 0 && failures-- > 0) throw std::runtime_error("init failed");
+      ready_ = true;
+    });
+  }
+
+  bool ready() const { return ready_; }
+
+private:
+  std::atomic<bool> ready_ { false };
+};
+
+std::atomic<int> GatedInit::ctorCalls { 0 };
+std::atomic<int> GatedInit::failures { 0 };
+std::promise<void>* GatedInit::gate = nullptr;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateAsyncPublishesInitialized)
+{
+  GatedInit::ctorCalls = 0;
+  di::Container container;
+  container.add<GatedInit, di::SharedScope, true>();
+  std::promise<void> gate;
+  GatedInit::gate = &gate;
+  auto future = container.createAsync<GatedInit*>();
+  while (GatedInit::ctorCalls == 0) {
+    std::this_thread::yield();
+  }
+  std::atomic<bool> done { false };
+  bool sawReady = false;
+  std::thread other([&container, &done, &sawReady]() {
+    sawReady = container.create<GatedInit*>()->ready();
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  BOOST_TEST(!done);
+  gate.set_value();
+  other.join();
+  GatedInit::gate = nullptr;
+  BOOST_TEST(sawReady);
+  BOOST_TEST(future.get() == container.create<GatedInit*>());
+  BOOST_TEST(GatedInit::ctorCalls == 1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateAsyncResetsFailed)
+{
+  GatedInit::ctorCalls = 0;
+  GatedInit::failures = 1;
+  di::Container container;
+  container.add<GatedInit, di::SharedScope, true>();
+  try {
+    container.createAsync<GatedInit*>().get();
+    BOOST_TEST(false);
+  }
+  catch (std::runtime_error&) {
+    BOOST_TEST(true);
+  }
+  auto instance = container.createAsync<GatedInit*>().get();
+  BOOST_TEST(instance->ready());
+  BOOST_TEST(GatedInit::ctorCalls == 2);
+  BOOST_TEST(container.create<GatedInit*>() == instance);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class PooledDependency final : public IDependency
+{
+public:
+  static int ctorCalls;
+  static int dtorCalls;
+
+public:
+  PooledDependency() { ++ctorCalls; }
+  ~PooledDependency() { ++dtorCalls; }
+  std::string& str() override { return str_; }
+  void reset() { str_.clear(); }
+
+private:
+  std::string str_;
+};
+
+int PooledDependency::ctorCalls = 0;
+int PooledDependency::dtorCalls = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PoolScope)
+{
+  PooledDependency::ctorCalls = 0;
+  di::Container container;
+  container.add<IDependency, PooledDependency, di::PoolScope<2>>();
+  container.add<SharedPtrDependant>();
+  IDependency* first = nullptr;
+  {
+    auto d1 = container.createShared<IDependency>();
+    auto d2 = container.createShared<IDependency>();
+    auto d3 = container.createShared<IDependency>();
+    d1->str() = "instance1";
+    first = d1.get();
+    BOOST_TEST(PooledDependency::ctorCalls == 3);
+  }
+  auto d4 = container.createShared<IDependency>();
+  auto d5 = container.createUnique<SharedPtrDependant>();
+  BOOST_TEST(PooledDependency::ctorCalls == 3);
+  BOOST_TEST((d4.get() == first || d5->dependency().get() == first));
+  BOOST_TEST(first->str().empty());
+  try {
+    container.createPtr<IDependency>();
+    BOOST_TEST(false);
+  }
+  catch (...) {}
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PoolScopeOutlivesContainer)
+{
+  PooledDependency::dtorCalls = 0;
+  std::shared_ptr<IDependency> pooled;
+  {
+    di::Container container;
+    container.add<IDependency, PooledDependency, di::PoolScope<2>>();
+    pooled = container.createShared<IDependency>();
+    container.createShared<IDependency>();
+  }
+  BOOST_TEST(PooledDependency::dtorCalls == 0);
+  pooled->str() = "alive";
+  BOOST_TEST(pooled->str() == "alive");
+  pooled.reset();
+  BOOST_TEST(PooledDependency::dtorCalls == 2);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <int N>
+struct SharedLeaf
+{
+  int value = N;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SingleAllocationShared)
+{
+  di::Container container;
+  container.add<IDependency, InitDependency, di::UniqueScope, true>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.addFactory<FactoryArg1, di::SharedScope>([]() { return new FactoryArg1 { 1 }; });
+  auto d1 = std::dynamic_pointer_cast<InitDependency>(container.createShared<IDependency>());
+  auto d2 = container.createShared<IDependency2>();
+  auto d3 = container.createShared<FactoryArg1>();
+  BOOST_TEST(d1->counter() == 1);
+  BOOST_TEST(d2 == container.createShared<IDependency2>());
+  BOOST_TEST(d2.use_count() == 2);
+  BOOST_TEST(d3->value == 1);
+  container.add<SharedLeaf<1>, di::SharedScope>();
+  container.add<SharedLeaf<2>, di::SharedScope>();
+  container.createShared<SharedLeaf<1>>();
+  auto allocations = allocationCount;
+  auto leaf = container.createShared<SharedLeaf<2>>();
+  BOOST_TEST(allocationCount - allocations == 1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  std::size_t allocations = 0;
+
+protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MemoryResource)
+{
+  CountingResource containerResource;
+  CountingResource registrationResource;
+  di::Container container(&containerResource);
+  container.add<IDependency, Dependency1>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.addMulti<IDependency, Dependency2, di::SharedScope>();
+  container.addMulti<IDependency, Dependency3, di::SharedScope>();
+  container.setResource<IDependency2>(&registrationResource);
+  container.createShared<IDependency>();
+  BOOST_TEST(containerResource.allocations == 1);
+  container.createShared<IDependency2>();
+  BOOST_TEST(containerResource.allocations == 1);
+  BOOST_TEST(registrationResource.allocations == 1);
+  auto vector = container.create<std::pmr::vector<std::shared_ptr<IDependency>>>();
+  BOOST_TEST(vector.size() == 2);
+  BOOST_TEST(vector.get_allocator().resource() == &containerResource);
+  BOOST_TEST(containerResource.allocations == 4);
+  std::unique_ptr<IDependency>(container.createPtr<IDependency>());
+  BOOST_TEST(containerResource.allocations == 4);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RequestScope)
+{
+  Dependency1::dtorCalls = 0;
+  di::Container container;
+  container.add<IDependency, Dependency1>();
+  container.add<PurePtrDependant>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.addFactory<FactoryArg1, di::UniqueScope>([]() { return new FactoryArg1 { 1 }; });
+  IDependency2* shared = nullptr;
+  {
+    char buffer[256];
+    di::RequestScope scope(container, buffer, sizeof(buffer));
+    auto d = scope.createPtr<PurePtrDependant>();
+    BOOST_TEST(d->dependency() != nullptr);
+    BOOST_TEST(scope.createShared<IDependency>() != nullptr);
+    BOOST_TEST(scope.createPtr<FactoryArg1>()->value == 1);
+    shared = scope.createPtr<IDependency2>();
+    BOOST_TEST(Dependency1::dtorCalls == 1);
+  }
+  BOOST_TEST(Dependency1::dtorCalls == 2);
+  BOOST_TEST(container.createPtr<IDependency2>() == shared);
+  std::unique_ptr<IDependency> d(container.createPtr<IDependency>());
+  BOOST_TEST(Dependency1::dtorCalls == 2);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ScopeLeaf
+{
+  int value = 7;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ScopeSingleton
+{
+  explicit ScopeSingleton(ScopeLeaf* leaf) : leaf(leaf) {}
+  std::unique_ptr<ScopeLeaf> leaf;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RequestScopeSingleton)
+{
+  di::Container container;
+  container.add<ScopeLeaf>();
+  container.add<ScopeSingleton, di::SharedScope>();
+  std::shared_ptr<ScopeLeaf> leaf;
+  std::unique_ptr<ScopeSingleton> owner;
+  {
+    di::RequestScope scope(container);
+    BOOST_TEST(scope.createPtr<ScopeSingleton>()->leaf->value == 7);
+    leaf = scope.createShared<ScopeLeaf>();
+    owner = scope.create<std::unique_ptr<ScopeSingleton>>();
+  }
+  BOOST_TEST(container.createPtr<ScopeSingleton>()->leaf->value == 7);
+  BOOST_TEST(leaf->value == 7);
+  BOOST_TEST(owner->leaf->value == 7);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct Payload
+{
+  static int copies;
+  static int moves;
+
+  Payload() = default;
+  Payload(const Payload& other) : data(other.data) { ++copies; }
+  Payload(Payload&& other) : data(std::move(other.data)) { ++moves; }
+  std::string data;
+};
+
+int Payload::copies = 0;
+int Payload::moves = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct PayloadDependant
+{
+  PayloadDependant(Payload payload, IDependency2* d) : payload(std::move(payload)), d(d) {}
+  Payload payload;
+  IDependency2* d;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct PayloadRefDependant
+{
+  PayloadRefDependant(const Payload& payload, IDependency2* d) : payload(&payload), d(d) {}
+  const Payload* payload;
+  IDependency2* d;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MoveRuntimeArgs)
+{
+  di::Container container;
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.add<PayloadDependant>();
+  container.add<PayloadRefDependant>();
+  Payload payload;
+  payload.data = "payload";
+  Payload::copies = 0;
+  Payload::moves = 0;
+  auto byValue = container.create<std::function<std::unique_ptr<PayloadDependant>(Payload&&)>>();
+  auto d1 = byValue(std::move(payload));
+  BOOST_TEST(d1->payload.data == "payload");
+  BOOST_TEST(Payload::copies == 0);
+  BOOST_TEST(Payload::moves == 2);
+  auto byConstRef = container.create<std::function<std::unique_ptr<PayloadDependant>(const Payload&)>>();
+  auto d2 = byConstRef(d1->payload);
+  BOOST_TEST(d1->payload.data == "payload");
+  BOOST_TEST(d2->payload.data == "payload");
+  BOOST_TEST(Payload::copies == 1);
+  auto ref = container.create<std::function<std::unique_ptr<PayloadRefDependant>(const Payload&)>>();
+  auto d3 = ref(d1->payload);
+  BOOST_TEST(d3->payload == &d1->payload);
+  BOOST_TEST(Payload::copies == 1);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateWithArgs)
+{
+  di::Container container;
+  container.add<FactoryResultPure>();
+  container.add<FactoryArg1, di::SharedScope>();
+  container.add<FactoryArg2, di::SharedScope>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.add<PayloadDependant>();
+  auto arg3 = std::make_shared<FactoryArg3>();
+  arg3->value = 3;
+  std::unique_ptr<FactoryResultPure> result(container.createPtr<FactoryResultPure>(arg3.get()));
+  BOOST_TEST(result->arg3 == arg3.get());
+  BOOST_TEST(result->arg1 == container.createPtr<FactoryArg1>());
+  auto shared = container.createShared<FactoryResultPure>(arg3.get());
+  BOOST_TEST(shared->arg3 == arg3.get());
+  Payload payload;
+  payload.data = "payload";
+  Payload::copies = 0;
+  auto dependant = container.freeze().createUnique<PayloadDependant>(std::move(payload));
+  BOOST_TEST(dependant->payload.data == "payload");
+  BOOST_TEST(Payload::copies == 0);
+  try
+  {
+    container.createPtr<FactoryResultPure>();
+    BOOST_TEST(false);
+  }
+  catch(...)
+  {
+    BOOST_TEST(true);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ProviderDependant
+{
+  ProviderDependant(di::Provider<std::unique_ptr<FactoryResultPure>> results, di::Provider<std::shared_ptr<IDependency2>> shared) :
+    results(results), shared(shared) {}
+  di::Provider<std::unique_ptr<FactoryResultPure>> results;
+  di::Provider<std::shared_ptr<IDependency2>> shared;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ProviderTest)
+{
+  di::Container container;
+  container.add<FactoryResultPure>();
+  container.add<FactoryArg1, di::SharedScope>();
+  container.add<FactoryArg2, di::SharedScope>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.add<ProviderDependant>();
+  auto dependant = container.createUnique<ProviderDependant>();
+  BOOST_TEST(static_cast<bool>(dependant->results));
+  FactoryArg3 arg3;
+  auto result1 = dependant->results(&arg3);
+  auto result2 = dependant->results(&arg3);
+  BOOST_TEST(result1.get() != result2.get());
+  BOOST_TEST(result1->arg3 == &arg3);
+  BOOST_TEST(result1->arg1 == result2->arg1);
+  BOOST_TEST(dependant->shared().get() == container.createPtr<IDependency2>());
+  BOOST_TEST(!di::Provider<int*>());
+  try
+  {
+    container.create<di::Provider<FactoryArg3*>>();
+    BOOST_TEST(false);
+  }
+  catch(...)
+  {
+    BOOST_TEST(true);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct LazyTarget
+{
+  LazyTarget() { ++created; }
+  static int created;
+};
+
+int LazyTarget::created = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct LazyDependant
+{
+  LazyDependant(di::Lazy<std::shared_ptr<LazyTarget>> target, di::Lazy<IDependency2*> dependency) :
+    target(std::move(target)), dependency(std::move(dependency)) {}
+  di::Lazy<std::shared_ptr<LazyTarget>> target;
+  di::Lazy<IDependency2*> dependency;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(LazyTest)
+{
+  di::Container container;
+  container.add<LazyTarget, di::SharedScope>();
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.add<LazyDependant>();
+  LazyTarget::created = 0;
+  auto dependant = container.createUnique<LazyDependant>();
+  BOOST_TEST(LazyTarget::created == 0);
+  BOOST_TEST(!dependant->target.created());
+  std::vector<std::thread> threads;
+  std::vector<LazyTarget*> targets(4);
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    threads.emplace_back([&, i]() { targets[i] = dependant->target.get().get(); });
+  }
+  for (auto& thread : threads) thread.join();
+  BOOST_TEST(LazyTarget::created == 1);
+  BOOST_TEST(dependant->target.created());
+  for (auto target : targets) BOOST_TEST(target == container.createPtr<LazyTarget>());
+  BOOST_TEST(dependant->dependency->integer() == container.createPtr<IDependency2>()->integer());
+  BOOST_TEST(*dependant->dependency == container.createPtr<IDependency2>());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct RefDependant
+{
+  explicit RefDependant(di::Ref<IDependency2> dependency) : dependency(dependency) {}
+  di::Ref<IDependency2> dependency;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RefTest)
+{
+  di::Container container;
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  container.add<RefDependant>();
+  auto shared = container.createShared<IDependency2>();
+  auto useCount = shared.use_count();
+  auto dependant = container.createUnique<RefDependant>();
+  BOOST_TEST(dependant->dependency.get() == shared.get());
+  BOOST_TEST(&dependant->dependency->integer() == &shared->integer());
+  BOOST_TEST(shared.use_count() == useCount);
+  di::Container unique;
+  unique.add<IDependency2, DoubleDependency>();
+  unique.add<RefDependant>();
+  try
+  {
+    unique.createUnique<RefDependant>();
+    BOOST_TEST(false);
+  }
+  catch(const std::runtime_error&)
+  {
+    BOOST_TEST(true);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SpecialTypeRegistration)
+{
+  di::Container container;
+  container.add<IDependency2, DoubleDependency, di::SharedScope>();
+  BOOST_TEST(container.createPtr<IDependency2>() == container.createShared<IDependency2>().get());
+  try
+  {
+    container.create<std::vector<IDependency2*>>();
+    BOOST_TEST(false);
+  }
+  catch(const std::runtime_error&)
+  {
+    BOOST_TEST(true);
+  }
+  container.add<std::vector<IDependency2*>>();
+  BOOST_TEST(container.create<std::vector<IDependency2*>>().empty());
+  BOOST_TEST(container.createPtr<IDependency2>() == container.createShared<IDependency2>().get());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct CachedVectorDependant
+{
+  explicit CachedVectorDependant(const std::vector<IDependency*>& dependencies) : dependencies(&dependencies) {}
+  const std::vector<IDependency*>* dependencies;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CachedSharedVector)
+{
+  di::Container container;
+  container.addMulti<IDependency, Dependency1, di::SharedScope>();
+  container.addMulti<IDependency, Dependency2, di::SharedImlpScope>();
+  container.add<CachedVectorDependant>();
+  auto dependant1 = container.createUnique<CachedVectorDependant>();
+  auto dependant2 = container.createUnique<CachedVectorDependant>();
+  BOOST_TEST(dependant1->dependencies == dependant2->dependencies);
+  BOOST_TEST(dependant1->dependencies->size() == 2);
+  BOOST_TEST(container.create<std::vector<IDependency*>>() == *dependant1->dependencies);
+  container.addMulti<IDependency, Dependency3, di::SharedScope>();
+  auto dependant3 = container.createUnique<CachedVectorDependant>();
+  BOOST_TEST(dependant3->dependencies->size() == 3);
+  BOOST_TEST((*dependant3->dependencies)[0] == (*dependant1->dependencies)[0]);
+  BOOST_TEST(dependant1->dependencies->size() == 2);
+  container.addMulti<IDependency, Dependency3>();
+  auto vector1 = container.create<std::vector<IDependency*>>();
+  auto vector2 = container.create<std::vector<IDependency*>>();
+  BOOST_TEST(vector1.size() == 4);
+  BOOST_TEST(vector1[3] != vector2[3]);
+  delete vector1[3];
+  delete vector2[3];
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <int N>
+struct ViewPlugin : public IDependency
+{
+  ViewPlugin() { ++created; }
+  std::string& str() override { return str_; }
+  static int created;
+  std::string str_ = std::to_string(N);
+};
+
+template <int N>
+int ViewPlugin<N>::created = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ViewDependant
+{
+  explicit ViewDependant(di::MultiView<std::unique_ptr<IDependency>> plugins) : plugins(plugins) {}
+  di::MultiView<std::unique_ptr<IDependency>> plugins;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MultiViewTest)
+{
+  di::Container container;
+  container.addMulti<IDependency, ViewPlugin<1>>();
+  container.addMulti<IDependency, ViewPlugin<2>>();
+  container.addMulti<IDependency, ViewPlugin<3>>();
+  container.add<ViewDependant>();
+  auto dependant = container.createUnique<ViewDependant>();
+  BOOST_TEST(dependant->plugins.size() == 3);
+  BOOST_TEST(ViewPlugin<1>::created + ViewPlugin<2>::created + ViewPlugin<3>::created == 0);
+  BOOST_TEST(dependant->plugins[1]->str() == "2");
+  BOOST_TEST(ViewPlugin<1>::created == 0);
+  BOOST_TEST(ViewPlugin<2>::created == 1);
+  BOOST_TEST(ViewPlugin<3>::created == 0);
+  std::string order;
+  for (auto plugin : dependant->plugins) order += plugin->str();
+  BOOST_TEST(order == "123");
+  container.addMulti<IDependency, ViewPlugin<4>>();
+  BOOST_TEST(dependant->plugins.size() == 3);
+  BOOST_TEST(container.create<di::MultiView<IDependency*>>().size() == 4);
+  try
+  {
+    container.create<di::MultiView<IDependency2*>>();
+    BOOST_TEST(false);
+  }
+  catch(const std::runtime_error&)
+  {
+    BOOST_TEST(true);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <int N>
+struct ParallelPart : public IDependency
+{
+  ParallelPart() : concurrent(Rendezvous::meet(3)) {}
+  std::string& str() override { return str_; }
+  bool concurrent;
+  std::string str_ = std::to_string(N);
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ParallelDependant
+{
+  ParallelDependant(ParallelPart<1>* part1, std::shared_ptr<ParallelPart<2>> part2, std::unique_ptr<ParallelPart<3>> part3) :
+    concurrent(part1->concurrent && part2->concurrent && part3->concurrent) {}
+  bool concurrent;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ParallelCycle;
+
+struct ParallelCycleBack
+{
+  explicit ParallelCycleBack(ParallelCycle* cycle) : cycle(cycle) {}
+  ParallelCycle* cycle;
+};
+
+struct ParallelCycle
+{
+  ParallelCycle(ParallelPart<1>* part, ParallelCycleBack* back) : part(part), back(back) {}
+  ParallelPart<1>* part;
+  ParallelCycleBack* back;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateParallel)
+{
+  di::Container container;
+  container.add<ParallelPart<1>, di::SharedScope>();
+  container.add<ParallelPart<2>, di::SharedScope>();
+  container.add<ParallelPart<3>>();
+  container.add<ParallelDependant>();
+  Rendezvous::arrived = 0;
+  BOOST_TEST(container.createParallel<std::unique_ptr<ParallelDependant>>()->concurrent);
+  container.addMulti<IDependency, ParallelPart<4>, di::SharedScope>();
+  container.addMulti<IDependency, ParallelPart<5>>();
+  container.addMulti<IDependency, ParallelPart<6>>();
+  Rendezvous::arrived = 0;
+  std::vector<std::thread> workers;
+  auto plugins = container.createParallel<std::vector<std::shared_ptr<IDependency>>>([&workers](std::function<void()> task) {
+    workers.emplace_back(std::move(task));
+  });
+  for (auto& worker : workers) worker.join();
+  BOOST_TEST(plugins.size() == 3);
+  BOOST_TEST(static_cast<ParallelPart<4>*>(plugins[0].get())->concurrent);
+  BOOST_TEST(static_cast<ParallelPart<5>*>(plugins[1].get())->concurrent);
+  BOOST_TEST(static_cast<ParallelPart<6>*>(plugins[2].get())->concurrent);
+  container.add<ParallelCycle, di::SharedScope>();
+  container.add<ParallelCycleBack, di::SharedScope>();
+  try
+  {
+    container.createParallel<ParallelCycle*>();
+    BOOST_TEST(false);
+  }
+  catch(const std::runtime_error& e)
+  {
+    BOOST_TEST(std::string(e.what()).find("Circular") != std::string::npos);
+  }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct InitLog
+{
+  static std::mutex mutex;
+  static std::vector<std::string> order;
+
+  static void add(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(name);
+  }
+
+  static std::size_t position(const std::string& name)
+  {
+    return std::find(order.begin(), order.end(), name) - order.begin();
+  }
+};
+
+std::mutex InitLog::mutex;
+std::vector<std::string> InitLog::order;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <int N>
+struct InitLeaf
+{
+  void init()
+  {
+    concurrent = Rendezvous::meet(2);
+    InitLog::add("leaf" + std::to_string(N));
+  }
+  bool concurrent = false;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct InitMiddle
+{
+  explicit InitMiddle(InitLeaf<1>* leaf) : leafInitedEarly(!InitLog::order.empty()) { (void)leaf; }
+  void init() { InitLog::add("middle"); }
+  bool leafInitedEarly;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct InitRoot
+{
+  InitRoot(InitMiddle* middle, InitLeaf<2>* leaf, InitLeaf<1>* shared) : middle(middle), leaf(leaf), shared(shared) {}
+  void init() { InitLog::add("root"); }
+  InitMiddle* middle;
+  InitLeaf<2>* leaf;
+  InitLeaf<1>* shared;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateDeferred)
+{
+  di::Container container;
+  container.add<InitLeaf<1>, di::SharedScope, true>();
+  container.add<InitLeaf<2>, di::SharedScope, true>();
+  container.add<InitMiddle, di::SharedScope, true>();
+  container.add<InitRoot, di::UniqueScope, true>();
+  Rendezvous::arrived = 0;
+  InitLog::order.clear();
+  di::InitReport report;
+  auto root = container.createDeferred<std::unique_ptr<InitRoot>>(&report);
+  BOOST_TEST(!root->middle->leafInitedEarly);
+  BOOST_TEST(root->shared->concurrent);
+  BOOST_TEST(root->leaf->concurrent);
+  BOOST_TEST(InitLog::order.size() == 4);
+  BOOST_TEST(InitLog::position("leaf1") < InitLog::position("middle"));
+  BOOST_TEST(InitLog::position("middle") < InitLog::position("root"));
+  BOOST_TEST(InitLog::position("leaf2") < InitLog::position("root"));
+  BOOST_TEST(report.inits.size() == 4);
+  BOOST_TEST(report.inits.back().type.find("InitRoot") != std::string::npos);
+  BOOST_TEST(report.serialTime.count() > 0);
+  InitLog::order.clear();
+  auto another = container.createDeferred<std::unique_ptr<InitRoot>>([](std::function<void()>) {});
+  BOOST_TEST(InitLog::order.size() == 1);
+  BOOST_TEST(another->middle == root->middle);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct DeferredDb
+{
+  DeferredDb() { ++created; }
+  void init()
+  {
+    if (fail) throw std::runtime_error("init failed");
+    ready = true;
+  }
+  bool ready = false;
+  static int created;
+  static bool fail;
+};
+
+int DeferredDb::created = 0;
+bool DeferredDb::fail = false;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct DeferredService
+{
+  explicit DeferredService(DeferredDb* db) : db(db) {}
+  void init() { sawReady = db->ready; }
+  DeferredDb* db;
+  bool sawReady = false;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateDeferredByValue)
+{
+  di::Container container;
+  container.add<DeferredDb, di::SharedScope, true>();
+  container.add<DeferredService, di::UniqueScope, true>();
+  auto service = container.createDeferred<DeferredService>([](std::function<void()>) {});
+  BOOST_TEST(service.sawReady);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateDeferredResetsFailed)
+{
+  di::Container container;
+  container.add<DeferredDb, di::SharedScope, true>();
+  container.add<DeferredService, di::UniqueScope, true>();
+  DeferredDb::created = 0;
+  DeferredDb::fail = true;
+  try {
+    container.createDeferred<std::unique_ptr<DeferredService>>([](std::function<void()>) {});
+    BOOST_TEST(false);
+  }
+  catch (const std::runtime_error&) {
+    BOOST_TEST(true);
+  }
+  DeferredDb::fail = false;
+  auto service = container.createDeferred<std::unique_ptr<DeferredService>>([](std::function<void()>) {});
+  BOOST_TEST(DeferredDb::created == 2);
+  BOOST_TEST(service->db->ready);
+  BOOST_TEST(service->sawReady);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ArgsArray)
+{
+  const std::string name = "name";
+  int number = 1;
+  double value = 2.5;
+  di::ArgsArray args(number, name, std::move(value));
+  di::Args& base = args;
+  auto it = base.find<int>();
+  BOOST_TEST(static_cast<bool>(it));
+  BOOST_TEST(!it.movable());
+  BOOST_TEST(&base.get<int>(it) == &number);
+  it = base.find<std::string>();
+  BOOST_TEST(!it.movable());
+  BOOST_TEST(base.get<const std::string&>(it) == "name");
+  it = base.find<double>();
+  BOOST_TEST(it.movable());
+  BOOST_TEST(base.get<double>(it) == 2.5);
+  BOOST_TEST(!base.find<char>());
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+template <std::size_t Size>
+struct TemporaryValue
+{
+  static int alive;
+
+  TemporaryValue() { ++alive; }
+  TemporaryValue(const TemporaryValue& other) : data(other.data) { ++alive; }
+  ~TemporaryValue() { --alive; }
+  std::array<char, Size> data {};
+};
+
+template <std::size_t Size>
+int TemporaryValue<Size>::alive = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct TemporariesDependant
+{
+  TemporariesDependant(const TemporaryValue<8>& small, const TemporaryValue<128>& big, const TemporaryValue<16>& other) :
+    alive(TemporaryValue<8>::alive + TemporaryValue<128>::alive + TemporaryValue<16>::alive),
+    distinct(static_cast<const void*>(&small) != static_cast<const void*>(&other))
+  {
+    (void)big;
+  }
+  int alive;
+  bool distinct;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ConstRefTemporaries)
+{
+  static_assert(di::BindsTemporaries<TemporariesDependant, di::Container, 0, 1, 2>);
+  static_assert(!di::BindsTemporaries<ScopeSingleton, di::Container, 0>);
+  di::Container container;
+  container.add<TemporaryValue<8>>();
+  container.add<TemporaryValue<16>>();
+  container.add<TemporaryValue<128>>();
+  container.add<TemporariesDependant>();
+  std::unique_ptr<TemporariesDependant> d(container.createPtr<TemporariesDependant>());
+  BOOST_TEST(d->alive == 3);
+  BOOST_TEST(d->distinct);
+  BOOST_TEST(TemporaryValue<8>::alive == 0);
+  BOOST_TEST(TemporaryValue<16>::alive == 0);
+  BOOST_TEST(TemporaryValue<128>::alive == 0);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct PooledBuffer
+{
+  static int ctorCalls;
+
+  explicit PooledBuffer(int size) : size(size) { ++ctorCalls; }
+  int size;
+};
+
+int PooledBuffer::ctorCalls = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PoolScopeWithArgs)
+{
+  PooledBuffer::ctorCalls = 0;
+  di::Container container;
+  container.add<PooledBuffer, di::PoolScope<1>>();
+  PooledBuffer* first = nullptr;
+  {
+    auto buffer = container.createShared<PooledBuffer>(1);
+    BOOST_TEST(buffer->size == 1);
+    first = buffer.get();
+  }
+  auto buffer = container.createShared<PooledBuffer>(2);
+  BOOST_TEST(buffer->size == 2);
+  BOOST_TEST(buffer.get() == first);
+  BOOST_TEST(PooledBuffer::ctorCalls == 2);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct ViewArgPlugin : public IDependency
+{
+  explicit ViewArgPlugin(int value) : str_(std::to_string(value)) {}
+  std::string& str() override { return str_; }
+  std::string str_;
+};
+
+static_assert(std::input_iterator<di::MultiView<IDependency*>::Iterator>);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MultiViewArgs)
+{
+  di::Container container;
+  container.addMulti<IDependency, ViewArgPlugin>();
+  auto view = container.create<di::MultiView<std::unique_ptr<IDependency>>>(5);
+  BOOST_TEST(view.create(0, 7)->str() == "7");
+  try {
+    view[0];
+    BOOST_TEST(false);
+  }
+  catch (const std::runtime_error&) {
+    BOOST_TEST(true);
+  }
+  auto other = container.create<di::MultiView<std::unique_ptr<IDependency>>>();
+  BOOST_TEST((view.begin() != other.begin()));
+  BOOST_TEST((view.begin() == view.begin()));
+  BOOST_TEST((++view.begin() == view.end()));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct PrefetchElement : public IDependency
+{
+  static int ctorCalls;
+
+  PrefetchElement() { ++ctorCalls; }
+  std::string& str() override { return str_; }
+  std::string str_;
+};
+
+int PrefetchElement::ctorCalls = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct PrefetchRefDependant
+{
+  PrefetchRefDependant(const std::vector<IDependency*>& elements, Dependency1* dependency) : dependency(dependency)
+  {
+    for (auto element : elements) this->elements.emplace_back(element);
+  }
+  std::vector<std::unique_ptr<IDependency>> elements;
+  std::unique_ptr<Dependency1> dependency;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct AnyArg
+{
+  template <typename U>
+  AnyArg(U&&) {}
+};
+
+// -----------------------------------------------------------------------------------------------------------------------------
+struct PrefetchOpaqueDependant
+{
+  PrefetchOpaqueDependant(ParallelPart<1>* part, Dependency1* dependency, AnyArg) : part(part), dependency(dependency) {}
+  ParallelPart<1>* part;
+  Dependency1* dependency;
+};
+
+using PrefetchSequence = std::integer_sequence<int, 0, 1, 2>;
+static_assert(!di::AcceptsOpaqueAt<PrefetchOpaqueDependant, di::Container, di::PrefetchArg, 0, PrefetchSequence>::value);
+static_assert(di::AcceptsOpaqueAt<PrefetchOpaqueDependant, di::Container, di::PrefetchArg, 2, PrefetchSequence>::value);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CreateParallelConstRef)
+{
+  PrefetchElement::ctorCalls = 0;
+  di::Container container;
+  container.addMulti<IDependency, PrefetchElement>();
+  container.add<Dependency1>();
+  container.add<PrefetchRefDependant>();
+  auto dependant = container.createParallel<std::unique_ptr<PrefetchRefDependant>>([](std::function<void()> task) { task(); });
+  BOOST_TEST(dependant->elements.size() == 1);
+  BOOST_TEST(PrefetchElement::ctorCalls == 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // !DiTest
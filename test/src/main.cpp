@@ -1,2 +1,27 @@
 #define BOOST_TEST_MODULE DiTest
 #include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+thread_local std::size_t allocationCount = 0;
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void* operator new(std::size_t size)
+{
+  ++allocationCount;
+  if (auto ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}